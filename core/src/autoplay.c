@@ -9,6 +9,7 @@
 #include "game.h"
 #include "gameplay.h"
 #include "infer.h"
+#include "movegen.h"
 #include "random.h"
 #include "thread_control.h"
 #include "ucgi_print.h"
@@ -33,6 +34,8 @@ AutoplayResults *create_autoplay_results() {
   autoplay_results->p1_firsts = 0;
   autoplay_results->p1_score = create_stat();
   autoplay_results->p2_score = create_stat();
+  autoplay_results->leave_cache_hits = 0;
+  autoplay_results->leave_cache_misses = 0;
   return autoplay_results;
 }
 
@@ -85,6 +88,17 @@ void add_autoplay_results(AutoplayResults *autoplay_results_1,
   autoplay_results_1->p1_losses += autoplay_results_2->p1_losses;
   autoplay_results_1->p1_ties += autoplay_results_2->p1_ties;
   autoplay_results_1->total_games += autoplay_results_2->total_games;
+  autoplay_results_1->leave_cache_hits += autoplay_results_2->leave_cache_hits;
+  autoplay_results_1->leave_cache_misses +=
+      autoplay_results_2->leave_cache_misses;
+}
+
+void add_leave_cache_results(Generator *gen,
+                             AutoplayResults *autoplay_results) {
+  if (gen->leave_cache) {
+    autoplay_results->leave_cache_hits += gen->leave_cache->hits;
+    autoplay_results->leave_cache_misses += gen->leave_cache->misses;
+  }
 }
 
 void play_game(Game *game, time_t seed, AutoplayResults *autoplay_results,
@@ -101,7 +115,7 @@ void play_game(Game *game, time_t seed, AutoplayResults *autoplay_results,
     generate_moves(game->gen, game->players[game->player_on_turn_index],
                    game->players[1 - game->player_on_turn_index]->rack,
                    game->gen->bag->last_tile_index + 1 >= RACK_SIZE);
-    play_move(game, game->gen->move_list->moves[0]);
+    play_move(game, &game->gen->move_list->moves[0]);
     reset_move_list(game->gen->move_list);
   }
   record_results(game, starting_player_index, autoplay_results);
@@ -130,6 +144,9 @@ void *autoplay_worker(void *uncasted_autoplay_worker) {
     }
   }
 
+  add_leave_cache_results(game_1->gen, autoplay_worker->autoplay_results);
+  add_leave_cache_results(game_2->gen, autoplay_worker->autoplay_results);
+
   destroy_game(game_1);
   destroy_game(game_2);
   return NULL;
@@ -1,6 +1,8 @@
 #ifndef AUTOPLAY_H
 #define AUTOPLAY_H
 
+#include <stdint.h>
+
 #include "config.h"
 #include "stats.h"
 #include "thread_control.h"
@@ -13,6 +15,8 @@ typedef struct AutoplayResults {
   int p1_firsts;
   Stat *p1_score;
   Stat *p2_score;
+  uint64_t leave_cache_hits;
+  uint64_t leave_cache_misses;
 } AutoplayResults;
 
 void autoplay(ThreadControl *thread_control, AutoplayResults *autoplay_results,
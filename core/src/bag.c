@@ -1,37 +1,83 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "bag.h"
+#include "undo_log.h"
 #include "xoshiro.h"
 
-void shuffle(Bag *bag) {
-  if (bag->last_tile_index > 0) {
-    int i;
-    for (i = 0; i < bag->last_tile_index; i++) {
-      int j = i + xoshiro_next(bag->prng) /
-                      (XOSHIRO_MAX / (bag->last_tile_index + 1 - i) + 1);
-      int t = bag->tiles[j];
-      bag->tiles[j] = bag->tiles[i];
-      bag->tiles[i] = t;
-    }
+void link_bag_tile(Bag *bag, int index, uint8_t letter) {
+  uint8_t first_index = bag->first_letter_index[letter];
+  bag->next_letter_index[index] = first_index;
+  bag->previous_letter_index[index] = NO_BAG_TILE_INDEX;
+  if (first_index != NO_BAG_TILE_INDEX) {
+    bag->previous_letter_index[first_index] = index;
   }
+  bag->first_letter_index[letter] = index;
+}
+
+void unlink_bag_tile(Bag *bag, int index, uint8_t letter) {
+  uint8_t next_index = bag->next_letter_index[index];
+  uint8_t previous_index = bag->previous_letter_index[index];
+  if (previous_index == NO_BAG_TILE_INDEX) {
+    bag->first_letter_index[letter] = next_index;
+  } else {
+    bag->next_letter_index[previous_index] = next_index;
+  }
+  if (next_index != NO_BAG_TILE_INDEX) {
+    bag->previous_letter_index[next_index] = previous_index;
+  }
+}
+
+// Writes the tile and moves its index to the list of the new letter.
+void write_bag_tile(Bag *bag, int index, uint8_t letter) {
+  if (bag->tiles[index] != EMPTY_BAG_TILE_MARKER) {
+    unlink_bag_tile(bag, index, bag->tiles[index]);
+  }
+  if (letter != EMPTY_BAG_TILE_MARKER) {
+    link_bag_tile(bag, index, letter);
+  }
+  bag->tiles[index] = letter;
+}
+
+void set_bag_tile(Bag *bag, int index, uint8_t letter) {
+  if (bag->undo_log) {
+    push_undo_entry(bag->undo_log, UNDO_BAG_TILE, index, bag->tiles[index]);
+  }
+  write_bag_tile(bag, index, letter);
+}
+
+// The journal restores the empty tiles as well, so the
+// lists match the restored last tile index.
+void undo_bag_change(Bag *bag, UndoEntry *entry) {
+  if (entry->type == UNDO_BAG_TILE) {
+    write_bag_tile(bag, entry->index, entry->old_value);
+  }
+}
+
+void empty_bag(Bag *bag) {
+  memset(bag->tiles, EMPTY_BAG_TILE_MARKER, sizeof(bag->tiles));
+  memset(bag->first_letter_index, NO_BAG_TILE_INDEX,
+         sizeof(bag->first_letter_index));
+  bag->last_tile_index = -1;
 }
 
 void reset_bag(Bag *bag, LetterDistribution *letter_distribution) {
+  empty_bag(bag);
   int idx = 0;
   for (uint32_t i = 0; i < (letter_distribution->size); i++) {
     for (uint32_t k = 0; k < letter_distribution->distribution[i]; k++) {
-      bag->tiles[idx] = i;
+      write_bag_tile(bag, idx, i);
       idx++;
     }
   }
-  bag->last_tile_index = sizeof(bag->tiles) - 1;
-  shuffle(bag);
+  bag->last_tile_index = idx - 1;
 }
 
 Bag *create_bag(LetterDistribution *letter_distribution) {
   Bag *bag = malloc(sizeof(Bag));
   // call reseed_prng if needed.
   bag->prng = create_prng(42);
+  bag->undo_log = NULL;
   reset_bag(bag, letter_distribution);
   return bag;
 }
@@ -39,14 +85,19 @@ Bag *create_bag(LetterDistribution *letter_distribution) {
 Bag *copy_bag(Bag *bag) {
   Bag *new_bag = malloc(sizeof(Bag));
   new_bag->prng = create_prng(42);
+  new_bag->undo_log = NULL;
   copy_bag_into(new_bag, bag);
   return new_bag;
 }
 
 void copy_bag_into(Bag *dst, Bag *src) {
-  for (int tile_index = 0; tile_index <= src->last_tile_index; tile_index++) {
-    dst->tiles[tile_index] = src->tiles[tile_index];
-  }
+  memcpy(dst->tiles, src->tiles, sizeof(dst->tiles));
+  memcpy(dst->first_letter_index, src->first_letter_index,
+         sizeof(dst->first_letter_index));
+  memcpy(dst->next_letter_index, src->next_letter_index,
+         sizeof(dst->next_letter_index));
+  memcpy(dst->previous_letter_index, src->previous_letter_index,
+         sizeof(dst->previous_letter_index));
   dst->last_tile_index = src->last_tile_index;
   copy_prng_into(dst->prng, src->prng);
 }
@@ -56,31 +107,42 @@ void destroy_bag(Bag *bag) {
   free(bag);
 }
 
+// Removes the tile by moving the last tile into its place.
+void remove_bag_tile(Bag *bag, int index) {
+  int last_tile_index = bag->last_tile_index;
+  uint8_t last_letter = bag->tiles[last_tile_index];
+  set_bag_tile(bag, last_tile_index, EMPTY_BAG_TILE_MARKER);
+  if (index != last_tile_index) {
+    set_bag_tile(bag, index, last_letter);
+  }
+  bag->last_tile_index--;
+}
+
 // This assumes the letter is in the bag
 void draw_letter(Bag *bag, uint8_t letter) {
   if (is_blanked(letter)) {
     letter = BLANK_MACHINE_LETTER;
   }
-  for (int i = 0; i <= bag->last_tile_index; i++) {
-    if (bag->tiles[i] == letter) {
-      bag->tiles[i] = bag->tiles[bag->last_tile_index];
-      bag->last_tile_index--;
-      return;
-    }
+  uint8_t index = bag->first_letter_index[letter];
+  if (index != NO_BAG_TILE_INDEX) {
+    remove_bag_tile(bag, index);
   }
 }
 
+// This assumes the bag is not empty
+uint8_t draw_random_letter(Bag *bag) {
+  int index = xoshiro_next_bounded(bag->prng, bag->last_tile_index + 1);
+  uint8_t letter = bag->tiles[index];
+  remove_bag_tile(bag, index);
+  return letter;
+}
+
+// Draws are random, so the letter can go at the end.
 void add_letter(Bag *bag, uint8_t letter) {
   if (is_blanked(letter)) {
     letter = BLANK_MACHINE_LETTER;
   }
-  int insert_index = 0;
-  if (bag->last_tile_index >= 0) {
-    // XXX: should use division instead?
-    insert_index = xoshiro_next(bag->prng) % (bag->last_tile_index + 1);
-  }
-  bag->tiles[bag->last_tile_index + 1] = bag->tiles[insert_index];
-  bag->tiles[insert_index] = letter;
+  set_bag_tile(bag, bag->last_tile_index + 1, letter);
   bag->last_tile_index++;
 }
 
@@ -5,22 +5,34 @@
 
 #include "constants.h"
 #include "letter_distribution.h"
+#include "undo_log.h"
 #include "xoshiro.h"
 
+// The tiles are unordered and each draw picks one at random, so the
+// bag never needs to be shuffled. The indexes of the tiles of each
+// letter are kept in doubly linked lists to find a letter without a
+// scan. The tiles past the last tile index are empty.
 typedef struct Bag {
   uint8_t tiles[BAG_SIZE];
+  uint8_t first_letter_index[MAX_ALPHABET_SIZE];
+  uint8_t next_letter_index[BAG_SIZE];
+  uint8_t previous_letter_index[BAG_SIZE];
   int last_tile_index;
   XoshiroPRNG *prng;
+  // When set, the tiles written are journaled here.
+  UndoLog *undo_log;
 } Bag;
 
 void add_letter(Bag *bag, uint8_t letter);
 void draw_letter(Bag *bag, uint8_t letter);
+uint8_t draw_random_letter(Bag *bag);
 void destroy_bag(Bag *bag);
 Bag *create_bag(LetterDistribution *letter_distribution);
 Bag *copy_bag(Bag *bag);
 void copy_bag_into(Bag *dst, Bag *src);
+void empty_bag(Bag *bag);
 void reseed_prng(Bag *bag, uint64_t seed);
 void reset_bag(Bag *bag, LetterDistribution *letter_distribution);
-void shuffle(Bag *bag);
+void undo_bag_change(Bag *bag, UndoEntry *entry);
 
 #endif
\ No newline at end of file
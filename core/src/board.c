@@ -6,6 +6,7 @@
 #include "board.h"
 #include "constants.h"
 #include "cross_set.h"
+#include "zobrist.h"
 
 board_layout_t
 board_layout_string_to_board_layout(const char *board_layout_string) {
@@ -18,22 +19,52 @@ board_layout_string_to_board_layout(const char *board_layout_string) {
   return BOARD_LAYOUT_UNKNOWN;
 }
 
-// Current index
-// depends on tranposition of the board
+int get_board_layout_dim(board_layout_t board_layout) {
+  switch (board_layout) {
+  case BOARD_LAYOUT_CROSSWORD_GAME:
+    return CROSSWORD_GAME_BOARD_DIM;
+  case BOARD_LAYOUT_SUPER_CROSSWORD_GAME:
+    return SUPER_CROSSWORD_GAME_BOARD_DIM;
+  default:
+    return 0;
+  }
+}
+
+// Index of a square in the copy read for the current
+// orientation and in the other copy.
+
+int get_view_index(int row, int col) { return row * BOARD_DIM + col; }
 
-int get_tindex(Board *board, int row, int col) {
-  return (row * (BOARD_DIM * (1 - board->transposed) + board->transposed)) +
-         (col * (BOARD_DIM * board->transposed + (1 - board->transposed)));
+int get_other_index(int row, int col) { return col * BOARD_DIM + row; }
+
+int get_cross_index(int index, int dir, int cross_set_index) {
+  return index * 2 + dir + (BOARD_DIM * BOARD_DIM * 2) * cross_set_index;
 }
 
-int get_tindex_dir(Board *board, int row, int col, int dir) {
-  return get_tindex(board, row, col) * 2 + dir;
+// Converts coordinates in the current orientation
+// to untransposed coordinates.
+void untranspose_coordinates(Board *board, int *row, int *col) {
+  if (board->transposed) {
+    int temp = *row;
+    *row = *col;
+    *col = temp;
+  }
 }
 
-int get_tindex_player_cross(Board *board, int row, int col, int dir,
-                            int cross_set_index) {
-  return get_tindex_dir(board, row, col, dir) +
-         (BOARD_DIM * BOARD_DIM * 2) * cross_set_index;
+// Points the getters at the copy for the current orientation.
+void set_view(Board *board) {
+  Board *squares = board->squares;
+  if (board->transposed) {
+    board->view_letters = squares->transposed_letters;
+    board->view_bonus_squares = squares->transposed_bonus_squares;
+    board->view_cross_sets = squares->transposed_cross_sets;
+    board->view_cross_scores = squares->transposed_cross_scores;
+  } else {
+    board->view_letters = squares->letters;
+    board->view_bonus_squares = squares->bonus_squares;
+    board->view_cross_sets = squares->cross_sets;
+    board->view_cross_scores = squares->cross_scores;
+  }
 }
 
 // Letters
@@ -42,65 +73,95 @@ int is_empty(Board *board, int row, int col) {
   return get_letter(board, row, col) == ALPHABET_EMPTY_SQUARE_MARKER;
 }
 
+// The index is always untransposed.
 void set_letter_by_index(Board *board, int index, uint8_t letter) {
+  // Writes that change nothing are skipped so
+  // that they do not fill the undo journal.
+  if (board->letters[index] == letter) {
+    return;
+  }
+  if (board->undo_log) {
+    push_undo_entry(board->undo_log, UNDO_BOARD_LETTER, index,
+                    board->letters[index]);
+  }
+  int row = index / BOARD_DIM;
+  int col = index % BOARD_DIM;
+  board->hash ^= get_square_key(index, board->letters[index]) ^
+                 get_square_key(index, letter);
   board->letters[index] = letter;
+  board->transposed_letters[get_other_index(row, col)] = letter;
+  if (letter == ALPHABET_EMPTY_SQUARE_MARKER) {
+    board->occupancy[0][row] &= ~((uint32_t)1 << col);
+    board->occupancy[1][col] &= ~((uint32_t)1 << row);
+  } else {
+    board->occupancy[0][row] |= (uint32_t)1 << col;
+    board->occupancy[1][col] |= (uint32_t)1 << row;
+  }
 }
 
 uint8_t get_letter_by_index(Board *board, int index) {
-  return board->letters[index];
+  return board->squares->letters[index];
 }
 
 void set_letter(Board *board, int row, int col, uint8_t letter) {
-  board->letters[get_tindex(board, row, col)] = letter;
+  untranspose_coordinates(board, &row, &col);
+  set_letter_by_index(board, get_view_index(row, col), letter);
 }
 
 uint8_t get_letter(Board *board, int row, int col) {
-  return board->letters[get_tindex(board, row, col)];
+  return board->view_letters[get_view_index(row, col)];
 }
 
+uint64_t board_hash(Board *board) { return board->hash; }
+
 // Anchors
 
 int get_anchor(Board *board, int row, int col, int vertical) {
-  return board->anchors[get_tindex_dir(board, row, col, vertical)];
-}
-
-void set_anchor(Board *board, int row, int col, int vertical) {
-  board->anchors[get_tindex_dir(board, row, col, vertical)] = 1;
+  untranspose_coordinates(board, &row, &col);
+  if (vertical) {
+    return (board->anchors[1][col] >> row) & 1;
+  }
+  return (board->anchors[0][row] >> col) & 1;
 }
 
-void reset_anchors(Board *board, int row, int col) {
-  board->anchors[get_tindex_dir(board, row, col, 0)] = 0;
-  board->anchors[get_tindex_dir(board, row, col, 1)] = 0;
+// Returns the anchors of the row in the current view
+// for plays along the row.
+uint32_t get_line_anchors(Board *board, int row) {
+  return board->anchors[board->transposed][row];
 }
 
 // Cross sets and scores
 
-uint64_t *get_cross_set_pointer(Board *board, int row, int col, int dir,
-                                int cross_set_index) {
-  return &board->cross_sets[get_tindex_player_cross(board, row, col, dir,
-                                                    cross_set_index)];
-}
-
 uint64_t get_cross_set(Board *board, int row, int col, int dir,
                        int cross_set_index) {
-  return board->cross_sets[get_tindex_player_cross(board, row, col, dir,
-                                                   cross_set_index)];
+  return board->view_cross_sets[get_cross_index(get_view_index(row, col), dir,
+                                                cross_set_index)];
 }
 
 void set_cross_score(Board *board, int row, int col, int score, int dir,
                      int cross_set_index) {
-  board->cross_scores[get_tindex_player_cross(board, row, col, dir,
-                                              cross_set_index)] = score;
+  untranspose_coordinates(board, &row, &col);
+  int index = get_cross_index(get_view_index(row, col), dir, cross_set_index);
+  if (board->cross_scores[index] == score) {
+    return;
+  }
+  if (board->undo_log) {
+    push_undo_entry(board->undo_log, UNDO_BOARD_CROSS_SCORE, index,
+                    (uint64_t)board->cross_scores[index]);
+  }
+  board->cross_scores[index] = score;
+  board->transposed_cross_scores[get_cross_index(
+      get_other_index(row, col), dir, cross_set_index)] = score;
 }
 
 int get_cross_score(Board *board, int row, int col, int dir,
                     int cross_set_index) {
-  return board->cross_scores[get_tindex_player_cross(board, row, col, dir,
-                                                     cross_set_index)];
+  return board->view_cross_scores[get_cross_index(get_view_index(row, col),
+                                                  dir, cross_set_index)];
 }
 
 uint8_t get_bonus_square(Board *board, int row, int col) {
-  return board->bonus_squares[get_tindex(board, row, col)];
+  return board->view_bonus_squares[get_view_index(row, col)];
 }
 
 void set_cross_set_letter(uint64_t *cross_set, uint8_t letter) {
@@ -109,31 +170,43 @@ void set_cross_set_letter(uint64_t *cross_set, uint8_t letter) {
 
 void set_cross_set(Board *board, int row, int col, uint64_t letter, int dir,
                    int cross_set_index) {
-  board->cross_sets[get_tindex_player_cross(board, row, col, dir,
-                                            cross_set_index)] = letter;
+  untranspose_coordinates(board, &row, &col);
+  int index = get_cross_index(get_view_index(row, col), dir, cross_set_index);
+  if (board->cross_sets[index] == letter) {
+    return;
+  }
+  if (board->undo_log) {
+    push_undo_entry(board->undo_log, UNDO_BOARD_CROSS_SET, index,
+                    board->cross_sets[index]);
+  }
+  board->cross_sets[index] = letter;
+  board->transposed_cross_sets[get_cross_index(
+      get_other_index(row, col), dir, cross_set_index)] = letter;
 }
 
 void clear_cross_set(Board *board, int row, int col, int dir,
                      int cross_set_index) {
-  board->cross_sets[get_tindex_player_cross(board, row, col, dir,
-                                            cross_set_index)] = 0;
+  set_cross_set(board, row, col, 0, dir, cross_set_index);
 }
 
 void set_all_crosses(Board *board) {
   for (int i = 0; i < NUMBER_OF_CROSSES; i++) {
     board->cross_sets[i] = TRIVIAL_CROSS_SET;
+    board->transposed_cross_sets[i] = TRIVIAL_CROSS_SET;
   }
 }
 
 void clear_all_crosses(Board *board) {
   for (size_t i = 0; i < NUMBER_OF_CROSSES; i++) {
     board->cross_sets[i] = 0;
+    board->transposed_cross_sets[i] = 0;
   }
 }
 
 void reset_all_cross_scores(Board *board) {
   for (size_t i = 0; i < (NUMBER_OF_CROSSES); i++) {
     board->cross_scores[i] = 0;
+    board->transposed_cross_scores[i] = 0;
   }
 }
 
@@ -171,65 +244,39 @@ int traverse_backwards_for_score(Board *board, int row, int col,
   return score;
 }
 
-void update_anchors(Board *board, int row, int col, int vertical) {
-  if (vertical) {
-    int temp = row;
-    row = col;
-    col = temp;
-  }
-
-  reset_anchors(board, row, col);
-  int tile_above = 0;
-  int tile_below = 0;
-  int tile_left = 0;
-  int tile_right = 0;
-  int tile_here = 0;
-
-  if (row > 0) {
-    tile_above = !is_empty(board, row - 1, col);
-  }
-  if (col > 0) {
-    tile_left = !is_empty(board, row, col - 1);
-  }
-  if (row < BOARD_DIM - 1) {
-    tile_below = !is_empty(board, row + 1, col);
-  }
-  if (col < BOARD_DIM - 1) {
-    tile_right = !is_empty(board, row, col + 1);
-  }
-  tile_here = !is_empty(board, row, col);
-  if (tile_here) {
-    if (!tile_right) {
-      set_anchor(board, row, col, 0);
-    }
-    if (!tile_below) {
-      set_anchor(board, row, col, 1);
-    }
-  } else {
-    if (!tile_left && !tile_right && (tile_above || tile_below)) {
-      set_anchor(board, row, col, 0);
+// Sets the anchors for plays along each line of one orientation.
+// A square is an anchor if it is the last tile of a word along the
+// line, or if it is empty, has no tiles beside it along the line and
+// touches a tile in a neighbouring line.
+void update_line_anchors(Board *board, int dir) {
+  const uint32_t line_mask = ((uint32_t)1 << BOARD_DIM) - 1;
+  uint32_t *occupancy = board->occupancy[dir];
+  for (int i = 0; i < BOARD_DIM; i++) {
+    uint32_t line = occupancy[i];
+    uint32_t neighbouring_lines = 0;
+    if (i > 0) {
+      neighbouring_lines |= occupancy[i - 1];
     }
-    if (!tile_above && !tile_below && (tile_left || tile_right)) {
-      set_anchor(board, row, col, 1);
+    if (i < BOARD_DIM - 1) {
+      neighbouring_lines |= occupancy[i + 1];
     }
+    uint32_t word_ends = line & ~(line >> 1);
+    uint32_t hooks =
+        ~(line | (line << 1) | (line >> 1)) & neighbouring_lines & line_mask;
+    board->anchors[dir][i] = word_ends | hooks;
   }
 }
 
 void update_all_anchors(Board *board) {
   if (board->tiles_played > 0) {
-    for (int i = 0; i < BOARD_DIM; i++) {
-      for (int j = 0; j < BOARD_DIM; j++) {
-        update_anchors(board, i, j, 0);
-      }
-    }
+    update_line_anchors(board, 0);
+    update_line_anchors(board, 1);
   } else {
+    int rc = BOARD_DIM / 2;
     for (int i = 0; i < BOARD_DIM; i++) {
-      for (int j = 0; j < BOARD_DIM; j++) {
-        reset_anchors(board, i, j);
-      }
+      board->anchors[0][i] = i == rc ? (uint32_t)1 << rc : 0;
+      board->anchors[1][i] = 0;
     }
-    int rc = BOARD_DIM / 2;
-    board->anchors[get_tindex_dir(board, rc, rc, 0)] = 1;
   }
 }
 
@@ -238,6 +285,8 @@ void reset_board(Board *board) {
   // it is used to calculate the index for set_letter.
   board->tiles_played = 0;
   board->transposed = 0;
+  board->squares = board;
+  set_view(board);
 
   for (int i = 0; i < BOARD_DIM; i++) {
     for (int j = 0; j < BOARD_DIM; j++) {
@@ -251,10 +300,19 @@ void reset_board(Board *board) {
 }
 
 void set_bonus_squares(Board *board) {
+#if BOARD_DIM == SUPER_CROSSWORD_GAME_BOARD_DIM
+  const char *layout = SUPER_CROSSWORD_GAME_BOARD;
+#else
+  const char *layout = CROSSWORD_GAME_BOARD;
+#endif
   for (int i = 0; i < BOARD_DIM * BOARD_DIM; i++) {
     uint8_t bonus_value;
-    char bonus_square = CROSSWORD_GAME_BOARD[i];
-    if (bonus_square == BONUS_TRIPLE_WORD_SCORE) {
+    char bonus_square = layout[i];
+    if (bonus_square == BONUS_QUADRUPLE_WORD_SCORE) {
+      bonus_value = 4;
+      bonus_value = bonus_value << 4;
+      bonus_value += 1;
+    } else if (bonus_square == BONUS_TRIPLE_WORD_SCORE) {
       bonus_value = 3;
       bonus_value = bonus_value << 4;
       bonus_value += 1;
@@ -270,12 +328,18 @@ void set_bonus_squares(Board *board) {
       bonus_value = 1;
       bonus_value = bonus_value << 4;
       bonus_value += 3;
+    } else if (bonus_square == BONUS_QUADRUPLE_LETTER_SCORE) {
+      bonus_value = 1;
+      bonus_value = bonus_value << 4;
+      bonus_value += 4;
     } else {
       bonus_value = 1;
       bonus_value = bonus_value << 4;
       bonus_value += 1;
     }
     board->bonus_squares[i] = bonus_value;
+    board->transposed_bonus_squares[get_other_index(
+        i / BOARD_DIM, i % BOARD_DIM)] = bonus_value;
   }
 }
 
@@ -326,16 +390,53 @@ int score_move(Board *board, uint8_t word[], int word_start_index,
   return main_word_score * word_multiplier + cross_scores + bingo_bonus;
 }
 
-void transpose(Board *board) { board->transposed = 1 - board->transposed; }
+void transpose(Board *board) {
+  board->transposed = 1 - board->transposed;
+  set_view(board);
+}
 
 void set_transpose(Board *board, int transpose) {
   board->transposed = transpose;
+  set_view(board);
 }
 
-void reset_transpose(Board *board) { board->transposed = 0; }
+void reset_transpose(Board *board) {
+  board->transposed = 0;
+  set_view(board);
+}
+
+// Writes the old value of a journaled change to both copies of the
+// board. The occupancy and anchors are not journaled and must be
+// restored by the caller.
+void undo_board_change(Board *board, UndoEntry *entry) {
+  int index = entry->index;
+  if (entry->type == UNDO_BOARD_LETTER) {
+    board->hash ^= get_square_key(index, board->letters[index]) ^
+                   get_square_key(index, entry->old_value);
+    board->letters[index] = entry->old_value;
+    board->transposed_letters[get_other_index(
+        index / BOARD_DIM, index % BOARD_DIM)] = entry->old_value;
+    return;
+  }
+  int cross_set_index = index / (BOARD_DIM * BOARD_DIM * 2);
+  int dir = index % 2;
+  int square_index = (index % (BOARD_DIM * BOARD_DIM * 2)) / 2;
+  int other_index = get_cross_index(
+      get_other_index(square_index / BOARD_DIM, square_index % BOARD_DIM),
+      dir, cross_set_index);
+  if (entry->type == UNDO_BOARD_CROSS_SET) {
+    board->cross_sets[index] = entry->old_value;
+    board->transposed_cross_sets[other_index] = entry->old_value;
+  } else if (entry->type == UNDO_BOARD_CROSS_SCORE) {
+    board->cross_scores[index] = (int)entry->old_value;
+    board->transposed_cross_scores[other_index] = (int)entry->old_value;
+  }
+}
 
 Board *create_board() {
-  Board *board = malloc(sizeof(Board));
+  // The setters skip unchanged squares, so both copies
+  // must start out equal.
+  Board *board = calloc(1, sizeof(Board));
   board->traverse_backwards_return_values =
       malloc(sizeof(TraverseBackwardsReturnValues));
   reset_board(board);
@@ -347,41 +448,63 @@ Board *copy_board(Board *board) {
   Board *new_board = malloc(sizeof(Board));
   new_board->traverse_backwards_return_values =
       malloc(sizeof(TraverseBackwardsReturnValues));
+  new_board->cross_set_cache = NULL;
+  new_board->undo_log = NULL;
   copy_board_into(new_board, board);
   return new_board;
 }
 
 // copy src into dst; assume dst is already allocated.
 void copy_board_into(Board *dst, Board *src) {
-  for (int board_index = 0; board_index < (BOARD_DIM * BOARD_DIM);
-       board_index++) {
-    dst->letters[board_index] = src->letters[board_index];
-    dst->bonus_squares[board_index] = src->bonus_squares[board_index];
-    int directional_board_index = board_index * 2;
-    dst->cross_sets[directional_board_index] =
-        src->cross_sets[directional_board_index];
-    dst->cross_sets[directional_board_index + 1] =
-        src->cross_sets[directional_board_index + 1];
-    dst->cross_scores[directional_board_index] =
-        src->cross_scores[directional_board_index];
-    dst->cross_scores[directional_board_index + 1] =
-        src->cross_scores[directional_board_index + 1];
-    dst->anchors[directional_board_index] =
-        src->anchors[directional_board_index];
-    dst->anchors[directional_board_index + 1] =
-        src->anchors[directional_board_index + 1];
-    if (board_index >= (BOARD_DIM * BOARD_DIM) ||
-        directional_board_index + 1 >= (BOARD_DIM * BOARD_DIM) * 2) {
-      printf("out of bounds: %d, %d\n", board_index,
-             directional_board_index + 1);
-      abort();
-    }
-  }
+  Board *squares = src->squares;
+  memcpy(dst->letters, squares->letters, sizeof(squares->letters));
+  memcpy(dst->bonus_squares, squares->bonus_squares,
+         sizeof(squares->bonus_squares));
+  memcpy(dst->cross_sets, squares->cross_sets, sizeof(squares->cross_sets));
+  memcpy(dst->cross_scores, squares->cross_scores,
+         sizeof(squares->cross_scores));
+  memcpy(dst->transposed_letters, squares->transposed_letters,
+         sizeof(squares->transposed_letters));
+  memcpy(dst->transposed_bonus_squares, squares->transposed_bonus_squares,
+         sizeof(squares->transposed_bonus_squares));
+  memcpy(dst->transposed_cross_sets, squares->transposed_cross_sets,
+         sizeof(squares->transposed_cross_sets));
+  memcpy(dst->transposed_cross_scores, squares->transposed_cross_scores,
+         sizeof(squares->transposed_cross_scores));
+  memcpy(dst->occupancy, src->occupancy, sizeof(src->occupancy));
+  memcpy(dst->anchors, src->anchors, sizeof(src->anchors));
+  dst->squares = dst;
+  dst->transposed = src->transposed;
+  dst->tiles_played = src->tiles_played;
+  dst->hash = src->hash;
+  set_view(dst);
+}
+
+// Makes dst a read only view of src that can be transposed
+// independently of it. The squares and crosses are read from src,
+// so only the line masks are copied. Neither board may be written
+// while the view is in use.
+void view_board_into(Board *dst, Board *src) {
+  memcpy(dst->occupancy, src->occupancy, sizeof(src->occupancy));
+  memcpy(dst->anchors, src->anchors, sizeof(src->anchors));
+  dst->squares = src->squares;
   dst->transposed = src->transposed;
   dst->tiles_played = src->tiles_played;
+  dst->hash = src->hash;
+  set_view(dst);
+}
+
+CrossSetCache *get_cross_set_cache(Board *board) {
+  if (!board->cross_set_cache) {
+    board->cross_set_cache = create_cross_set_cache();
+  }
+  return board->cross_set_cache;
 }
 
 void destroy_board(Board *board) {
   free(board->traverse_backwards_return_values);
+  if (board->cross_set_cache) {
+    destroy_cross_set_cache(board->cross_set_cache);
+  }
   free(board);
 }
\ No newline at end of file
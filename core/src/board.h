@@ -4,13 +4,19 @@
 #include <stdint.h>
 
 #include "constants.h"
+#include "cross_set_cache.h"
 #include "letter_distribution.h"
+#include "undo_log.h"
 
 // Use 2 * 2 for
 // vertical and horizontal sets and
 // player 1 and player 2 sets, when using different lexica
 #define NUMBER_OF_CROSSES BOARD_DIM *BOARD_DIM * 2 * 2
 
+#if BOARD_DIM > 32
+#error "board lines are stored as 32 bit masks"
+#endif
+
 typedef enum {
   BOARD_LAYOUT_UNKNOWN,
   BOARD_LAYOUT_CROSSWORD_GAME,
@@ -27,29 +33,63 @@ typedef struct Board {
 
   uint64_t cross_sets[NUMBER_OF_CROSSES];
   int cross_scores[NUMBER_OF_CROSSES];
-  int anchors[BOARD_DIM * BOARD_DIM * 2];
+
+  // The same squares stored column by column. Every setter updates
+  // both copies, so a transposed board is read with the same row
+  // major indexing as an untransposed one.
+  uint8_t transposed_letters[BOARD_DIM * BOARD_DIM];
+  uint8_t transposed_bonus_squares[BOARD_DIM * BOARD_DIM];
+  uint64_t transposed_cross_sets[NUMBER_OF_CROSSES];
+  int transposed_cross_scores[NUMBER_OF_CROSSES];
+
+  // Bitboards with one mask per line. Index 0 holds the rows with a
+  // bit per column and index 1 holds the columns with a bit per row,
+  // so the masks of the current view are at index transposed.
+  // The anchors at index 0 are horizontal and at index 1 vertical.
+  uint32_t occupancy[2][BOARD_DIM];
+  uint32_t anchors[2][BOARD_DIM];
+
+  // The board whose squares and crosses are read, which is this
+  // board unless it is a read only view of another board.
+  struct Board *squares;
+  // The copies read by the getters, set when the board is transposed.
+  uint8_t *view_letters;
+  uint8_t *view_bonus_squares;
+  uint64_t *view_cross_sets;
+  int *view_cross_scores;
+
   int transposed;
   int tiles_played;
+  // Zobrist hash of the letters, updated by every change to a square.
+  uint64_t hash;
   TraverseBackwardsReturnValues *traverse_backwards_return_values;
+  // Created on first use, so that boards which never
+  // generate cross sets do not allocate it.
+  CrossSetCache *cross_set_cache;
+  // When set, the letters, cross sets and cross scores
+  // written by the setters are journaled here.
+  UndoLog *undo_log;
 } Board;
 
 board_layout_t
 board_layout_string_to_board_layout(const char *board_layout_string);
+int get_board_layout_dim(board_layout_t board_layout);
 void clear_all_crosses(Board *board);
 void clear_cross_set(Board *board, int row, int col, int dir,
                      int cross_set_index);
 Board *create_board();
 Board *copy_board(Board *board);
+CrossSetCache *get_cross_set_cache(Board *board);
 void copy_board_into(Board *dst, Board *src);
 void destroy_board(Board *board);
 int get_anchor(Board *board, int row, int col, int vertical);
+uint32_t get_line_anchors(Board *board, int row);
+uint64_t board_hash(Board *board);
 uint8_t get_bonus_square(Board *board, int row, int col);
 int get_cross_score(Board *board, int row, int col, int dir,
                     int cross_set_index);
 uint64_t get_cross_set(Board *board, int row, int col, int dir,
                        int cross_set_index);
-uint64_t *get_cross_set_pointer(Board *board, int row, int col, int dir,
-                                int cross_set_index);
 uint8_t get_letter(Board *board, int row, int col);
 uint8_t get_letter_by_index(Board *board, int index);
 int is_empty(Board *board, int row, int col);
@@ -69,11 +109,12 @@ int score_move(Board *board, uint8_t word[], int word_start_index,
                int cross_dir, int cross_set_index,
                LetterDistribution *letter_distribution);
 void transpose(Board *board);
+void view_board_into(Board *dst, Board *src);
+void undo_board_change(Board *board, UndoEntry *entry);
 void reset_transpose(Board *board);
 void set_transpose(Board *board, int transpose);
 int traverse_backwards_for_score(Board *board, int row, int col,
                                  LetterDistribution *letter_distribution);
-void update_anchors(Board *board, int row, int col, int vertical);
 void update_all_anchors(Board *board);
 int word_edge(Board *board, int row, int col, int dir);
 
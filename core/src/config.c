@@ -12,6 +12,15 @@
 #include "log.h"
 #include "util.h"
 
+KWG *create_config_kwg(const char *kwg_filename, int kwg_load_mode,
+                       int use_kwg_index) {
+  KWG *kwg = create_kwg_with_load_mode(kwg_filename, kwg_load_mode);
+  if (use_kwg_index) {
+    build_kwg_index(kwg);
+  }
+  return kwg;
+}
+
 Config *create_config(const char *letter_distribution_filename, const char *cgp,
                       const char *kwg_filename_1, const char *klv_filename_1,
                       int move_sorting_1, int play_recorder_type_1,
@@ -23,7 +32,9 @@ Config *create_config(const char *letter_distribution_filename, const char *cgp,
                       int player_to_infer_index, int actual_score,
                       int number_of_tiles_exchanged, double equity_margin,
                       int number_of_threads, const char *winpct_filename,
-                      int move_list_capacity) {
+                      int move_list_capacity, int kwg_load_mode,
+                      int use_kwg_index, int leave_cache_capacity,
+                      int defer_blank_designations) {
 
   Config *config = malloc(sizeof(Config));
   config->letter_distribution =
@@ -44,10 +55,15 @@ Config *create_config(const char *letter_distribution_filename, const char *cgp,
   config->number_of_tiles_exchanged = number_of_tiles_exchanged;
   config->equity_margin = equity_margin;
   config->number_of_threads = number_of_threads;
+  config->kwg_load_mode = kwg_load_mode;
+  config->use_kwg_index = use_kwg_index;
+  config->leave_cache_capacity = leave_cache_capacity;
+  config->defer_blank_designations = defer_blank_designations;
 
   StrategyParams *player_1_strategy_params = malloc(sizeof(StrategyParams));
   if (strcmp(kwg_filename_1, "") != 0) {
-    player_1_strategy_params->kwg = create_kwg(kwg_filename_1);
+    player_1_strategy_params->kwg =
+        create_config_kwg(kwg_filename_1, kwg_load_mode, use_kwg_index);
     strcpy(player_1_strategy_params->kwg_filename, kwg_filename_1);
   } else {
     player_1_strategy_params->kwg = NULL;
@@ -71,7 +87,8 @@ Config *create_config(const char *letter_distribution_filename, const char *cgp,
     config->kwg_is_shared = 1;
   } else {
     strcpy(player_2_strategy_params->kwg_filename, kwg_filename_2);
-    player_2_strategy_params->kwg = create_kwg(kwg_filename_2);
+    player_2_strategy_params->kwg =
+        create_config_kwg(kwg_filename_2, kwg_load_mode, use_kwg_index);
     config->kwg_is_shared = 0;
   }
 
@@ -146,6 +163,12 @@ Config *create_config_from_args(int argc, char *argv[]) {
 
   char winpct_filename[(MAX_ARG_LENGTH)] = "";
   int use_game_pairs = 1;
+  int kwg_load_mode = KWG_LOAD_MODE_MMAP;
+  // The kwg index costs 33 bytes per node and did not
+  // pay for itself in measured autoplay, so it is opt in.
+  int use_kwg_index = 0;
+  int leave_cache_capacity = LEAVE_CACHE_SIZE;
+  int defer_blank_designations = 0;
 
   int c;
   long n;
@@ -162,7 +185,9 @@ Config *create_config_from_args(int argc, char *argv[]) {
         {"e", required_argument, 0, 1015},  {"q", required_argument, 0, 1016},
         {"h", required_argument, 0, 1017},  {"w", required_argument, 0, 1018},
         {"f", required_argument, 0, 1019},  {"k", required_argument, 0, 1020},
-        {"p", required_argument, 0, 1021},  {0, 0, 0, 0}};
+        {"p", required_argument, 0, 1021},  {"ki", required_argument, 0, 1022},
+        {"lc", required_argument, 0, 1023}, {"kl", required_argument, 0, 1024},
+        {"db", required_argument, 0, 1025}, {0, 0, 0, 0}};
     int option_index = 0;
     c = getopt_long_only(argc, argv, "", long_options, &option_index);
 
@@ -321,6 +346,40 @@ Config *create_config_from_args(int argc, char *argv[]) {
       use_game_pairs = (int)n;
       break;
 
+    case 1022:
+      check_arg_length(optarg);
+      n = strtol(optarg, NULL, 10);
+      use_kwg_index = (int)n;
+      break;
+
+    case 1023:
+      check_arg_length(optarg);
+      n = strtol(optarg, NULL, 10);
+      leave_cache_capacity = (int)n;
+      break;
+
+    case 1024:
+      check_arg_length(optarg);
+      if (!strcmp("mmap", optarg)) {
+        // Not strictly necessary since this
+        // is the default.
+        kwg_load_mode = KWG_LOAD_MODE_MMAP;
+      } else if (!strcmp("copy", optarg)) {
+        kwg_load_mode = KWG_LOAD_MODE_COPY;
+      } else if (!strcmp("relayout", optarg)) {
+        kwg_load_mode = KWG_LOAD_MODE_RELAYOUT;
+      } else {
+        printf("invalid kwg load mode option: %s\n", optarg);
+        exit(EXIT_FAILURE);
+      }
+      break;
+
+    case 1025:
+      check_arg_length(optarg);
+      n = strtol(optarg, NULL, 10);
+      defer_blank_designations = (int)n;
+      break;
+
     case '?':
       /* getopt_long already printed an error message. */
       break;
@@ -336,7 +395,9 @@ Config *create_config_from_args(int argc, char *argv[]) {
       move_sorting_2, play_recorder_type_2, use_game_pairs,
       number_of_games_or_pairs, print_info, checkstop, actual_tiles_played,
       player_to_infer_index, actual_score, number_of_tiles_exchanged,
-      equity_margin, number_of_threads, winpct_filename, MOVE_LIST_CAPACITY);
+      equity_margin, number_of_threads, winpct_filename, MOVE_LIST_CAPACITY,
+      kwg_load_mode, use_kwg_index, leave_cache_capacity,
+      defer_blank_designations);
 }
 
 void destroy_config(Config *config) {
@@ -391,7 +452,8 @@ void load_config_from_lexargs(Config **config, const char *cgp,
     *config = create_config(dist, cgp, lexicon_file, leaves, SORT_BY_EQUITY,
                             PLAY_RECORDER_TYPE_ALL, "", "", SORT_BY_EQUITY,
                             PLAY_RECORDER_TYPE_ALL, 0, 0, 9, 0, "", 0, 0, 0, 0,
-                            0, winpct, 100);
+                            0, winpct, 100, KWG_LOAD_MODE_MMAP, 0,
+                            LEAVE_CACHE_SIZE, 0);
   } else {
     Config *c = (*config);
     // check each filename
@@ -405,7 +467,8 @@ void load_config_from_lexargs(Config **config, const char *cgp,
     if (strcmp(c->player_1_strategy_params->kwg_filename, lexicon_file)) {
       log_debug("reloading kwg #1");
       destroy_kwg(c->player_1_strategy_params->kwg);
-      c->player_1_strategy_params->kwg = create_kwg(lexicon_file);
+      c->player_1_strategy_params->kwg =
+          create_config_kwg(lexicon_file, c->kwg_load_mode, c->use_kwg_index);
       // assume the kwg applies to both players if we're using this function
       assert(c->kwg_is_shared);
       c->player_2_strategy_params->kwg = c->player_1_strategy_params->kwg;
@@ -35,6 +35,18 @@ typedef struct Config {
   int number_of_tiles_exchanged;
   double equity_margin;
   int number_of_threads;
+  // One of the KWG_LOAD_MODE constants.
+  int kwg_load_mode;
+  // Whether to build the kwg letter mask and hook index,
+  // which speeds up move generation at a memory cost.
+  int use_kwg_index;
+  // The number of racks whose leave values each move generator
+  // keeps. A capacity of 0 disables the leave cache.
+  int leave_cache_capacity;
+  // Whether move generation searches a tile that could come from
+  // either the rack or a blank once and designates the blanks only
+  // for the plays that are found.
+  int defer_blank_designations;
   // Sim params
   WinPct *win_pcts;
   char win_pct_filename[MAX_DATA_FILENAME_LENGTH];
@@ -51,7 +63,9 @@ Config *create_config(
     int game_pair_flag, int number_of_games_or_pairs, int print_info,
     int checkstop, const char *actual_tiles_played, int player_to_infer_index,
     int actual_score, int number_of_tiles_exchanged, double equity_margin,
-    int number_of_threads, const char *winpct_filename, int move_list_capacity);
+    int number_of_threads, const char *winpct_filename, int move_list_capacity,
+    int kwg_load_mode, int use_kwg_index, int leave_cache_capacity,
+    int defer_blank_designations);
 Config *create_config_from_args(int argc, char *argv[]);
 void destroy_config(Config *config);
 StrategyParams *copy_strategy_params(StrategyParams *orig);
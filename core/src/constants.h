@@ -16,7 +16,11 @@
 #define BLANK_MASK 0x80
 #define UNBLANK_MASK (0x80 - 1)
 #define INITIAL_LAST_ANCHOR_COL (BOARD_DIM)
+#ifndef BOARD_DIM
 #define BOARD_DIM 15
+#endif
+#define CROSSWORD_GAME_BOARD_DIM 15
+#define SUPER_CROSSWORD_GAME_BOARD_DIM 21
 #define BINGO_BONUS 50
 #define GADDAG_NUM_ARCS_BIT_LOC 24
 #define GADDAG_LETTER_BIT_LOC 24
@@ -25,6 +29,7 @@
 #define BLANK_OFFSET 100
 #define BLANK_MACHINE_LETTER 0
 #define SEPARATION_MACHINE_LETTER 0
+#define KWG_UNREACHABLE_LENGTH 255
 #define TRIVIAL_CROSS_SET (uint64_t)((uint64_t)1 << MAX_ALPHABET_SIZE) - 1
 #define WORD_DIRECTION_RIGHT 1
 #define WORD_DIRECTION_LEFT -1
@@ -32,7 +37,10 @@
 #define BLANK_TOKEN "?"
 #define ASCII_PLAYED_THROUGH '.'
 #define BAG_SIZE 100
+#define EMPTY_BAG_TILE_MARKER MACHINE_LETTER_MAX_VALUE
+#define NO_BAG_TILE_INDEX BAG_SIZE
 #define RACK_SIZE 7
+#define RACK_SIGNATURE_MAX_LETTERS 8
 #define BOARD_HORIZONTAL_DIRECTION 0
 #define BOARD_VERTICAL_DIRECTION 1
 #define GAME_END_REASON_NONE 0
@@ -48,6 +56,13 @@
 #define SORT_BY_EQUITY 1
 #define PLAY_RECORDER_TYPE_ALL 0
 #define PLAY_RECORDER_TYPE_TOP_EQUITY 1
+#define PLAY_RECORDER_TYPE_TOP_K 2
+#define PLAY_RECORDER_TYPE_EQUITY_WINDOW 3
+#define PLAY_RECORDER_TYPE_VISITOR 4
+#define PLAY_RECORDER_TYPE_EQUITY_THRESHOLD 5
+#define KWG_LOAD_MODE_COPY 0
+#define KWG_LOAD_MODE_MMAP 1
+#define KWG_LOAD_MODE_RELAYOUT 2
 #define PREENDGAME_ADJUSTMENT_VALUES_TYPE_ZERO 0
 #define PREENDGAME_ADJUSTMENT_VALUES_TYPE_QUACKLE 1
 #define INFERENCE_STATUS_SUCCESS 0
@@ -61,6 +76,11 @@
 #define INFERENCE_STATUS_INVALID_NUMBER_OF_THREADS 8
 #define START_ROUNDED_EQUITY_VALUE -100
 #define MOVE_LIST_CAPACITY 1000000
+#define MOVE_LIST_INITIAL_SIZE 4096
+#define CROSS_SET_CACHE_SIZE 4096
+#define LEAVE_CACHE_SIZE 1024
+#define ROLLOUT_CACHE_SIZE 4096
+#define MAX_LEAVE_RANK_TABLE_SIZE (1 << 24)
 #define PASS_MOVE_EQUITY -10000
 #define INITIAL_TOP_MOVE_EQUITY -100000
 #define MAX_SCORELESS_TURNS 6
@@ -70,15 +90,22 @@
 #define BONUS_DOUBLE_WORD_SCORE '-'
 #define BONUS_TRIPLE_LETTER_SCORE '"'
 #define BONUS_DOUBLE_LETTER_SCORE '\''
+#define BONUS_QUADRUPLE_WORD_SCORE '~'
+#define BONUS_QUADRUPLE_LETTER_SCORE '^'
 #define DATA_DIRECTORY "data"
 #define KLV_FILENAME_EXTENSION "lg"
 #define MAX_ARG_LENGTH 300
+#define MAX_CGP_LENGTH 1024
 #define SIM_STOPPING_CONDITION_NONE 0
 #define SIM_STOPPING_CONDITION_95PCT 1
 #define SIM_STOPPING_CONDITION_98PCT 2
 #define SIM_STOPPING_CONDITION_99PCT 3
 #define BACKUP_MODE_OFF 0
 #define BACKUP_MODE_SIMULATION 1
+#define UNDO_LOG_INITIAL_CAPACITY 1024
+#define ZOBRIST_SQUARE_SEED (uint64_t)0x5a0b2157c4e1d0f3
+#define ZOBRIST_RACK_SEED (uint64_t)0x2e6f1c9a83b74d05
+#define ZOBRIST_GAME_SEED (uint64_t)0x71d3a8e45f092bc6
 #define UCGI_MODE_OFF 0
 #define UCGI_MODE_ON 1
 #define CROSSWORD_GAME_BOARD                                                   \
@@ -98,8 +125,29 @@
   " -   \"   \"   - "                                                          \
   "=  '   =   '  ="
 
-#define MAX_DATA_FILENAME_LENGTH 64
+#define SUPER_CROSSWORD_GAME_BOARD                                             \
+  "~  '   =  '  =   '  ~"                                                      \
+  " -  \"   -   -   \"  - "                                                    \
+  "  -  ^   - -   ^  -  "                                                      \
+  "'  =  '   -   '  =  '"                                                      \
+  " \"  -   \"   \"   -  \" "                                                  \
+  "  ^  -   ' '   -  ^  "                                                      \
+  "   '  -   '   -  '   "                                                      \
+  "=      -     -      ="                                                      \
+  " -  \"   '   '   \"  - "                                                    \
+  "  -  '   ' '   '  -  "                                                      \
+  "'  -  '   -   '  -  '"                                                      \
+  "  -  '   ' '   '  -  "                                                      \
+  " -  \"   '   '   \"  - "                                                    \
+  "=      -     -      ="                                                      \
+  "   '  -   '   -  '   "                                                      \
+  "  ^  -   ' '   -  ^  "                                                      \
+  " \"  -   \"   \"   -  \" "                                                  \
+  "'  =  '   -   '  =  '"                                                      \
+  "  -  ^   - -   ^  -  "                                                      \
+  " -  \"   -   -   \"  - "                                                    \
+  "~  '   =  '  =   '  ~"
 
-// want superOMG board as well.
+#define MAX_DATA_FILENAME_LENGTH 64
 
 #endif
\ No newline at end of file
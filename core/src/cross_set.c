@@ -75,12 +75,35 @@ void gen_cross_set(Board *board, int row, int col, int dir, int cross_set_index,
       set_cross_set(board, row, col, 0, dir, cross_set_index);
       return;
     }
-    uint32_t s_index =
-        kwg_get_next_node_index(kwg, lnode_index, SEPARATION_MACHINE_LETTER);
-    uint64_t letter_set = kwg_get_letter_set(kwg, s_index);
-    set_cross_set(board, row, col, letter_set, dir, cross_set_index);
+    set_cross_set(board, row, col, kwg_get_back_hooks(kwg, lnode_index), dir,
+                  cross_set_index);
   } else {
     int left_col = word_edge(board, row, col - 1, WORD_DIRECTION_LEFT);
+    // A square between two words tries every tile, so it is
+    // looked up by the letters of both words first.
+    CrossSetCacheEntry *cache_entry = NULL;
+    uint8_t letters[BOARD_DIM];
+    int left_length = col - left_col;
+    int right_length = right_col - col;
+    if (left_col != col) {
+      for (int i = 0; i < left_length; i++) {
+        letters[i] = get_letter(board, row, left_col + i);
+      }
+      for (int i = 0; i < right_length; i++) {
+        letters[left_length + i] = get_letter(board, row, col + 1 + i);
+      }
+      int found;
+      cache_entry = lookup_cross_set_cache(get_cross_set_cache(board), kwg,
+                                           letters, left_length, right_length,
+                                           &found);
+      if (found) {
+        set_cross_score(board, row, col, cache_entry->cross_score, dir,
+                        cross_set_index);
+        set_cross_set(board, row, col, cache_entry->cross_set, dir,
+                      cross_set_index);
+        return;
+      }
+    }
     traverse_backwards(board, row, right_col, kwg_get_root_node_index(kwg), 0,
                        0, kwg);
     uint32_t lnode_index = board->traverse_backwards_return_values->node_index;
@@ -89,18 +112,21 @@ void gen_cross_set(Board *board, int row, int col, int dir, int cross_set_index,
                                                letter_distribution);
     int score_l =
         traverse_backwards_for_score(board, row, col - 1, letter_distribution);
-    set_cross_score(board, row, col, score_r + score_l, dir, cross_set_index);
+    int score = score_r + score_l;
+    set_cross_score(board, row, col, score, dir, cross_set_index);
     if (!lpath_is_valid) {
       set_cross_set(board, row, col, 0, dir, cross_set_index);
+      if (cache_entry) {
+        set_cross_set_cache_entry(cache_entry, kwg, letters, left_length,
+                                  right_length, 0, score);
+      }
       return;
     }
     if (left_col == col) {
-      uint64_t letter_set = kwg_get_letter_set(kwg, lnode_index);
-      set_cross_set(board, row, col, letter_set, dir, cross_set_index);
+      set_cross_set(board, row, col, kwg_get_front_hooks(kwg, lnode_index),
+                    dir, cross_set_index);
     } else {
-      uint64_t *cross_set =
-          get_cross_set_pointer(board, row, col, dir, cross_set_index);
-      *cross_set = 0;
+      uint64_t cross_set = 0;
       for (int i = lnode_index;; i++) {
         int t = kwg_tile(kwg, i);
         if (t != 0) {
@@ -108,13 +134,16 @@ void gen_cross_set(Board *board, int row, int col, int dir, int cross_set_index,
           traverse_backwards(board, row, col - 1, next_node_index, 1, left_col,
                              kwg);
           if (board->traverse_backwards_return_values->path_is_valid) {
-            set_cross_set_letter(cross_set, t);
+            set_cross_set_letter(&cross_set, t);
           }
         }
         if (kwg_is_end(kwg, i)) {
           break;
         }
       }
+      set_cross_set(board, row, col, cross_set, dir, cross_set_index);
+      set_cross_set_cache_entry(cache_entry, kwg, letters, left_length,
+                                right_length, cross_set, score);
     }
   }
 }
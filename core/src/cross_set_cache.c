@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "constants.h"
+#include "cross_set_cache.h"
+#include "direct_mapped_cache.h"
+#include "kwg.h"
+
+CrossSetCache *create_cross_set_cache() {
+  // Entries without a kwg are empty.
+  return create_direct_mapped_cache(CROSS_SET_CACHE_SIZE,
+                                    sizeof(CrossSetCacheEntry));
+}
+
+void destroy_cross_set_cache(CrossSetCache *cross_set_cache) {
+  destroy_direct_mapped_cache(cross_set_cache);
+}
+
+uint64_t get_cross_set_cache_hash(KWG *kwg, const uint8_t *letters,
+                                  int left_length, int right_length) {
+  uint64_t hash = (uintptr_t)kwg;
+  hash = (hash ^ left_length) * 0x100000001b3;
+  for (int i = 0; i < left_length + right_length; i++) {
+    hash = (hash ^ letters[i]) * 0x100000001b3;
+  }
+  return hash ^ (hash >> 32);
+}
+
+// Returns the entry for the key. If found is set to 0,
+// the entry holds another key and can be overwritten.
+CrossSetCacheEntry *lookup_cross_set_cache(CrossSetCache *cross_set_cache,
+                                           KWG *kwg, const uint8_t *letters,
+                                           int left_length, int right_length,
+                                           int *found) {
+  CrossSetCacheEntry *entry = get_direct_mapped_cache_entry(
+      cross_set_cache,
+      get_cross_set_cache_hash(kwg, letters, left_length, right_length));
+  *found = entry->kwg == kwg && entry->left_length == left_length &&
+           entry->right_length == right_length &&
+           memcmp(entry->letters, letters, left_length + right_length) == 0;
+  record_direct_mapped_cache_lookup(cross_set_cache, *found);
+  return entry;
+}
+
+void set_cross_set_cache_entry(CrossSetCacheEntry *entry, KWG *kwg,
+                               const uint8_t *letters, int left_length,
+                               int right_length, uint64_t cross_set,
+                               int cross_score) {
+  entry->kwg = kwg;
+  entry->left_length = left_length;
+  entry->right_length = right_length;
+  memcpy(entry->letters, letters, left_length + right_length);
+  entry->cross_set = cross_set;
+  entry->cross_score = cross_score;
+}
@@ -0,0 +1,38 @@
+#ifndef CROSS_SET_CACHE_H
+#define CROSS_SET_CACHE_H
+
+#include <stdint.h>
+
+#include "constants.h"
+#include "direct_mapped_cache.h"
+#include "kwg.h"
+
+// The cross set and score of an empty square between two words,
+// keyed by the letters of both words and the lexicon.
+typedef struct CrossSetCacheEntry {
+  KWG *kwg;
+  uint64_t cross_set;
+  int cross_score;
+  uint8_t left_length;
+  uint8_t right_length;
+  // The left word followed by the right word.
+  uint8_t letters[BOARD_DIM];
+} CrossSetCacheEntry;
+
+// Owned by the board and shared by both players. The key does not
+// depend on where the words are, so it keeps hitting across moves
+// as the same short words end up next to empty squares.
+typedef DirectMappedCache CrossSetCache;
+
+CrossSetCache *create_cross_set_cache();
+void destroy_cross_set_cache(CrossSetCache *cross_set_cache);
+CrossSetCacheEntry *lookup_cross_set_cache(CrossSetCache *cross_set_cache,
+                                           KWG *kwg, const uint8_t *letters,
+                                           int left_length, int right_length,
+                                           int *found);
+void set_cross_set_cache_entry(CrossSetCacheEntry *entry, KWG *kwg,
+                               const uint8_t *letters, int left_length,
+                               int right_length, uint64_t cross_set,
+                               int cross_score);
+
+#endif
@@ -0,0 +1,26 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "direct_mapped_cache.h"
+
+extern inline void *get_direct_mapped_cache_entry(DirectMappedCache *cache,
+                                                  uint64_t hash);
+extern inline void record_direct_mapped_cache_lookup(DirectMappedCache *cache,
+                                                     int found);
+
+DirectMappedCache *create_direct_mapped_cache(int capacity,
+                                              size_t entry_size) {
+  DirectMappedCache *cache = malloc(sizeof(DirectMappedCache));
+  cache->entries = calloc(capacity, entry_size);
+  cache->entry_size = entry_size;
+  cache->capacity = capacity;
+  cache->hits = 0;
+  cache->misses = 0;
+  return cache;
+}
+
+void destroy_direct_mapped_cache(DirectMappedCache *cache) {
+  free(cache->entries);
+  free(cache);
+}
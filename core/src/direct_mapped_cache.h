@@ -0,0 +1,37 @@
+#ifndef DIRECT_MAPPED_CACHE_H
+#define DIRECT_MAPPED_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// A fixed size table in which each key can only be stored in the
+// entry its hash selects, so a new key replaces the key already there.
+// The caches built on it define their entries and compare their keys.
+// Entries start zeroed. It is not thread safe.
+typedef struct DirectMappedCache {
+  char *entries;
+  size_t entry_size;
+  int capacity;
+  uint64_t hits;
+  uint64_t misses;
+} DirectMappedCache;
+
+DirectMappedCache *create_direct_mapped_cache(int capacity, size_t entry_size);
+void destroy_direct_mapped_cache(DirectMappedCache *cache);
+
+// The hash selects the entry by its low bits, so it must already be mixed.
+inline void *get_direct_mapped_cache_entry(DirectMappedCache *cache,
+                                           uint64_t hash) {
+  return cache->entries + (hash % cache->capacity) * cache->entry_size;
+}
+
+inline void record_direct_mapped_cache_lookup(DirectMappedCache *cache,
+                                              int found) {
+  if (found) {
+    cache->hits++;
+  } else {
+    cache->misses++;
+  }
+}
+
+#endif
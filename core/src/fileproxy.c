@@ -21,15 +21,26 @@ typedef struct FileCache {
 
 static FileCache file_cache = {0};
 
-FILE *stream_from_filename(const char *filename) {
-  // Look in cache.
+FileCacheEntry *get_cache_entry(const char *filename) {
   for (int i = 0; i < file_cache.num_items; i++) {
     if (strcmp(file_cache.entries[i].filename, filename) == 0) {
-      log_debug("Found %s in cache...", filename);
-      return fmemopen(file_cache.entries[i].raw_data,
-                      file_cache.entries[i].byte_size, "r");
+      return &file_cache.entries[i];
     }
   }
+  return NULL;
+}
+
+int file_is_cached(const char *filename) {
+  return get_cache_entry(filename) != NULL;
+}
+
+FILE *stream_from_filename(const char *filename) {
+  // Look in cache.
+  FileCacheEntry *entry = get_cache_entry(filename);
+  if (entry != NULL) {
+    log_debug("Found %s in cache...", filename);
+    return fmemopen(entry->raw_data, entry->byte_size, "r");
+  }
   log_debug("%s not found in cache (size %d), opening", filename,
             file_cache.num_items);
   FILE *stream;
@@ -4,6 +4,7 @@
 #include <stdio.h>
 
 FILE *stream_from_filename(const char *filename);
+int file_is_cached(const char *filename);
 void precache_file(const char *filename);
 void destroy_cache();
 
@@ -11,6 +11,9 @@
 #include "game.h"
 #include "movegen.h"
 #include "player.h"
+#include "undo_log.h"
+#include "xoshiro.h"
+#include "zobrist.h"
 
 char add_player_score(const char *cgp, int *cgp_index, Game *game,
                       int player_index) {
@@ -206,10 +209,21 @@ void load_cgp(Game *game, const char *cgp) {
   }
 }
 
+// return the number of rows of the board in the cgp string.
+int get_cgp_board_dim(const char *cgp) {
+  int board_dim = 1;
+  for (int i = 0; cgp[i] != ' ' && cgp[i] != '\0'; i++) {
+    if (cgp[i] == '/') {
+      board_dim++;
+    }
+  }
+  return board_dim;
+}
+
 // return lexicon and letter distribution from the cgp string.
 void lexicon_ld_from_cgp(char *cgp, char *lexicon, char *ldname) {
   // copy string since we are going to modify it with strtok :(
-  char cgpcopy[512];
+  char cgpcopy[MAX_CGP_LENGTH];
   strcpy(cgpcopy, cgp);
   char *token;
   token = strtok(cgpcopy, " ");
@@ -244,6 +258,12 @@ int tiles_unseen(Game *game) {
   return (their_rack_tiles + bag_idx + 1);
 }
 
+// Starts or stops journaling the writes to the board and bag.
+void attach_undo_log(Game *game, UndoLog *undo_log) {
+  game->gen->board->undo_log = undo_log;
+  game->gen->bag->undo_log = undo_log;
+}
+
 void reset_game(Game *game) {
   reset_generator(game->gen);
   reset_player(game->players[0]);
@@ -252,6 +272,10 @@ void reset_game(Game *game) {
   game->consecutive_scoreless_turns = 0;
   game->game_end_reason = GAME_END_REASON_NONE;
   game->backup_cursor = 0;
+  if (game->backups_preallocated) {
+    game->undo_log->number_of_entries = 0;
+    attach_undo_log(game, NULL);
+  }
 }
 
 void set_player_on_turn(Game *game, int player_on_turn_index) {
@@ -262,13 +286,12 @@ void pre_allocate_backups(Game *game) {
   // pre-allocate heap backup structures to make backups as fast as possible.
   for (int i = 0; i < MAX_SEARCH_DEPTH; i++) {
     game->game_backups[i] = malloc(sizeof(MinimalGameBackup));
-    game->game_backups[i]->bag = create_bag(game->gen->letter_distribution);
-    game->game_backups[i]->board = create_board();
     game->game_backups[i]->p0rack =
         create_rack(game->gen->letter_distribution->size);
     game->game_backups[i]->p1rack =
         create_rack(game->gen->letter_distribution->size);
   }
+  game->undo_log = create_undo_log(UNDO_LOG_INITIAL_CAPACITY);
 }
 
 void set_backup_mode(Game *game, int backup_mode) {
@@ -323,8 +346,14 @@ void backup_game(Game *game) {
   }
   if (game->backup_mode == BACKUP_MODE_SIMULATION) {
     MinimalGameBackup *state = game->game_backups[game->backup_cursor];
-    copy_board_into(state->board, game->gen->board);
-    copy_bag_into(state->bag, game->gen->bag);
+    Board *board = game->gen->board;
+    Bag *bag = game->gen->bag;
+    state->undo_log_mark = game->undo_log->number_of_entries;
+    memcpy(state->occupancy, board->occupancy, sizeof(board->occupancy));
+    memcpy(state->anchors, board->anchors, sizeof(board->anchors));
+    state->board_tiles_played = board->tiles_played;
+    state->bag_last_tile_index = bag->last_tile_index;
+    copy_prng_into(&state->prng, bag->prng);
     state->game_end_reason = game->game_end_reason;
     state->player_on_turn_index = game->player_on_turn_index;
     state->consecutive_scoreless_turns = game->consecutive_scoreless_turns;
@@ -333,6 +362,9 @@ void backup_game(Game *game) {
     copy_rack_into(state->p1rack, game->players[1]->rack);
     state->p1score = game->players[1]->score;
 
+    if (game->backup_cursor == 0) {
+      attach_undo_log(game, game->undo_log);
+    }
     game->backup_cursor++;
   }
 }
@@ -353,18 +385,57 @@ void unplay_last_move(Game *game) {
   game->players[1]->score = state->p1score;
   copy_rack_into(game->players[0]->rack, state->p0rack);
   copy_rack_into(game->players[1]->rack, state->p1rack);
-  copy_bag_into(game->gen->bag, state->bag);
-  copy_board_into(game->gen->board, state->board);
+
+  // Replay the journal in reverse, so that each square and tile
+  // ends up with the value it had before its first change.
+  Board *board = game->gen->board;
+  Bag *bag = game->gen->bag;
+  UndoLog *undo_log = game->undo_log;
+  for (int i = undo_log->number_of_entries - 1; i >= state->undo_log_mark;
+       i--) {
+    UndoEntry *entry = &undo_log->entries[i];
+    if (entry->type == UNDO_BAG_TILE) {
+      undo_bag_change(bag, entry);
+    } else {
+      undo_board_change(board, entry);
+    }
+  }
+  undo_log->number_of_entries = state->undo_log_mark;
+  if (game->backup_cursor == 0) {
+    attach_undo_log(game, NULL);
+  }
+
+  memcpy(board->occupancy, state->occupancy, sizeof(board->occupancy));
+  memcpy(board->anchors, state->anchors, sizeof(board->anchors));
+  board->tiles_played = state->board_tiles_played;
+  bag->last_tile_index = state->bag_last_tile_index;
+  copy_prng_into(bag->prng, &state->prng);
+}
+
+// The board and racks keep their hashes up to date. The scores and
+// turn are mixed in here, since they are few and set in many places.
+uint64_t game_hash(Game *game) {
+  uint64_t hash = board_hash(game->gen->board);
+  for (int i = 0; i < 2; i++) {
+    Player *player = game->players[i];
+    hash ^= zobrist_mix(ZOBRIST_GAME_SEED * (2 * i + 1) + player->rack->hash);
+    hash ^= zobrist_mix(ZOBRIST_GAME_SEED * (2 * i + 2) +
+                        (uint32_t)player->score);
+  }
+  hash ^= zobrist_mix(ZOBRIST_GAME_SEED * 5 +
+                      ((uint64_t)game->player_on_turn_index << 32) +
+                      ((uint64_t)game->consecutive_scoreless_turns << 16) +
+                      game->game_end_reason);
+  return hash;
 }
 
 void destroy_backups(Game *game) {
   for (int i = 0; i < MAX_SEARCH_DEPTH; i++) {
     destroy_rack(game->game_backups[i]->p0rack);
     destroy_rack(game->game_backups[i]->p1rack);
-    destroy_bag(game->game_backups[i]->bag);
-    destroy_board(game->game_backups[i]->board);
     free(game->game_backups[i]);
   }
+  destroy_undo_log(game->undo_log);
 }
 
 void destroy_game(Game *game) {
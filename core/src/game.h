@@ -8,6 +8,8 @@
 #include "movegen.h"
 #include "player.h"
 #include "rack.h"
+#include "undo_log.h"
+#include "xoshiro.h"
 
 #define MAX_SEARCH_DEPTH 25
 
@@ -17,9 +19,16 @@ typedef enum {
   GAME_VARIANT_WORDSMOG,
 } game_variant_t;
 
+// The state before a backed up move. The board letters, cross sets,
+// cross scores and bag tiles are restored from the undo log entries
+// after undo_log_mark, and the rest is small enough to copy.
 typedef struct MinimalGameBackup {
-  Board *board;
-  Bag *bag;
+  int undo_log_mark;
+  uint32_t occupancy[2][BOARD_DIM];
+  uint32_t anchors[2][BOARD_DIM];
+  int board_tiles_played;
+  int bag_last_tile_index;
+  XoshiroPRNG prng;
   Rack *p0rack;
   Rack *p1rack;
   int p0score;
@@ -36,6 +45,9 @@ typedef struct Game {
   int consecutive_scoreless_turns;
   int game_end_reason;
   MinimalGameBackup *game_backups[MAX_SEARCH_DEPTH];
+  // Attached to the board and bag while any backup is held, so that
+  // it also journals the moves played after the last backup.
+  UndoLog *undo_log;
   int backup_cursor;
   int backup_mode;
   int backups_preallocated;
@@ -50,6 +62,8 @@ void draw_letter_to_rack(Bag *bag, Rack *rack, uint8_t letter);
 void set_backup_mode(Game *game, int backup_mode);
 void backup_game(Game *game);
 void unplay_last_move(Game *game);
+uint64_t game_hash(Game *game);
+int get_cgp_board_dim(const char *cgp);
 void lexicon_ld_from_cgp(char *cgp, char *lexicon, char *ldname);
 int tiles_unseen(Game *game);
 game_variant_t get_game_variant_type_from_name(const char *variant_name);
@@ -10,8 +10,7 @@
 
 void draw_at_most_to_rack(Bag *bag, Rack *rack, int n) {
   while (n > 0 && bag->last_tile_index >= 0) {
-    add_letter_to_rack(rack, bag->tiles[bag->last_tile_index]);
-    bag->last_tile_index--;
+    add_letter_to_rack(rack, draw_random_letter(bag));
     n--;
   }
 }
@@ -33,30 +32,7 @@ void play_move_on_board(Game *game, Move *move) {
   }
   game->gen->board->tiles_played += move->tiles_played;
 
-  // updateAnchorsForMove
-  int row = move->row_start;
-  int col = move->col_start;
-  if (move->vertical) {
-    row = move->col_start;
-    col = move->row_start;
-  }
-
-  for (int i = col; i < move->tiles_length + col; i++) {
-    update_anchors(game->gen->board, row, i, move->vertical);
-    if (row > 0) {
-      update_anchors(game->gen->board, row - 1, i, move->vertical);
-    }
-    if (row < BOARD_DIM - 1) {
-      update_anchors(game->gen->board, row + 1, i, move->vertical);
-    }
-  }
-  if (col - 1 >= 0) {
-    update_anchors(game->gen->board, row, col - 1, move->vertical);
-  }
-  if (move->tiles_length + col < BOARD_DIM) {
-    update_anchors(game->gen->board, row, move->tiles_length + col,
-                   move->vertical);
-  }
+  update_all_anchors(game->gen->board);
 }
 
 void calc_for_across(int row_start, int col_start, int csd, Game *game,
@@ -219,5 +195,5 @@ Move *get_top_equity_move(Game *game) {
                  game->gen->bag->last_tile_index + 1 >= RACK_SIZE);
   // restore old recorder type
   sp->play_recorder_type = recorder_type;
-  return game->gen->move_list->moves[0];
+  return &game->gen->move_list->moves[0];
 }
\ No newline at end of file
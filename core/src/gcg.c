@@ -494,7 +494,7 @@ Rack *get_rack_from_matching(GCGParser *gcg_parser, int group_index) {
 gcg_parse_status_t copy_position_to_game_event(GCGParser *gcg_parser,
                                                GameEvent *game_event,
                                                int group_index) {
-  game_event->move->row_start = 0;
+  int row_start = 0;
   int start_index = gcg_parser->matching_groups[group_index].rm_so;
   int end_index = gcg_parser->matching_groups[group_index].rm_eo;
   for (int i = start_index; i < end_index; i++) {
@@ -504,8 +504,7 @@ gcg_parse_status_t copy_position_to_game_event(GCGParser *gcg_parser,
         game_event->move->vertical = 0;
       }
       // Build the 1-indexed row_start
-      game_event->move->row_start =
-          game_event->move->row_start * 10 + (position_char - '0');
+      row_start = row_start * 10 + (position_char - '0');
     } else if (position_char >= 'A' && position_char <= 'Z') {
       if (i == start_index) {
         game_event->move->vertical = 1;
@@ -516,11 +515,11 @@ gcg_parse_status_t copy_position_to_game_event(GCGParser *gcg_parser,
     }
   }
   // Convert the 1-index row start into 0-indexed row start
-  game_event->move->row_start--;
+  row_start--;
+  game_event->move->row_start = row_start;
   if (game_event->move->col_start < 0 ||
-      game_event->move->col_start > BOARD_DIM ||
-      game_event->move->row_start < 0 ||
-      game_event->move->row_start > BOARD_DIM) {
+      game_event->move->col_start > BOARD_DIM || row_start < 0 ||
+      row_start > BOARD_DIM) {
     return GCG_PARSE_STATUS_INVALID_TILE_PLACEMENT_POSITION;
   }
   return GCG_PARSE_STATUS_SUCCESS;
@@ -764,6 +763,10 @@ gcg_parse_status_t parse_next_gcg_line(GCGParser *gcg_parser) {
     game_history->board_layout =
         board_layout_string_to_board_layout(board_layout_string);
     free(board_layout_string);
+    if (game_history->board_layout != BOARD_LAYOUT_UNKNOWN &&
+        get_board_layout_dim(game_history->board_layout) != BOARD_DIM) {
+      return GCG_PARSE_STATUS_UNSUPPORTED_BOARD_LAYOUT;
+    }
     break;
   case GCG_TILE_DISTRIBUTION_NAME_TOKEN:
     if (game_history->number_of_events > 0) {
@@ -26,6 +26,7 @@ typedef enum {
   GCG_PARSE_STATUS_PLAY_OUT_OF_BOUNDS,
   GCG_PARSE_STATUS_REDUNDANT_PRAGMA,
   GCG_PARSE_STATUS_GAME_EVENTS_OVERFLOW,
+  GCG_PARSE_STATUS_UNSUPPORTED_BOARD_LAYOUT,
 } gcg_parse_status_t;
 
 gcg_parse_status_t parse_gcg(const char *gcg_filename,
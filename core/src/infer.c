@@ -9,6 +9,7 @@
 #include "kwg.h"
 #include "leave_rack.h"
 #include "move.h"
+#include "movegen.h"
 #include "rack.h"
 #include "stats.h"
 #include "thread_control.h"
@@ -34,6 +35,8 @@ Inference *create_inference(int capacity, int distribution_size) {
   inference->draw_and_leave_subtotals_size =
       distribution_size * (RACK_SIZE) * 2;
   inference->total_racks_evaluated = 0;
+  inference->leave_cache_hits = 0;
+  inference->leave_cache_misses = 0;
   inference->bag_as_rack = create_rack(distribution_size);
   inference->leave = create_rack(distribution_size);
   inference->exchanged = create_rack(distribution_size);
@@ -220,24 +223,52 @@ Move *get_top_move(Inference *inference) {
   generate_moves(game->gen, player,
                  game->players[1 - inference->player_to_infer_index]->rack,
                  game->gen->bag->last_tile_index + 1 >= RACK_SIZE);
-  return game->gen->move_list->moves[0];
+  return &game->gen->move_list->moves[0];
+}
+
+// Returns whether the player to infer has a play with equity above
+// the threshold. Generation stops at the first such play.
+int has_move_above_equity(Inference *inference, double equity_threshold) {
+  Game *game = inference->game;
+  Player *player = game->players[inference->player_to_infer_index];
+  int play_recorder_type = player->strategy_params->play_recorder_type;
+  player->strategy_params->play_recorder_type =
+      PLAY_RECORDER_TYPE_EQUITY_THRESHOLD;
+  game->gen->equity_threshold = equity_threshold;
+  reset_move_list(game->gen->move_list);
+  generate_moves(game->gen, player,
+                 game->players[1 - inference->player_to_infer_index]->rack,
+                 game->gen->bag->last_tile_index + 1 >= RACK_SIZE);
+  player->strategy_params->play_recorder_type = play_recorder_type;
+  return game->gen->move_list->count > 0;
 }
 
 void evaluate_possible_leave(Inference *inference) {
   double current_leave_value = 0;
+  Move *top_move = NULL;
+  int recordable;
   if (inference->number_of_tiles_exchanged == 0) {
     current_leave_value = get_leave_value(inference->klv, inference->leave);
-  }
-  Move *top_move = get_top_move(inference);
-  int is_within_equity_margin = inference->actual_score + current_leave_value +
+    // An empty bag records every leave, otherwise the leave is
+    // recordable unless some play beats the actual play by more
+    // than the equity margin.
+    recordable = inference->bag_as_rack->empty ||
+                 !has_move_above_equity(
+                     inference, inference->actual_score + current_leave_value +
                                     inference->equity_margin +
-                                    (INFERENCE_EQUITY_EPSILON) >=
-                                top_move->equity;
-  int number_exchanged_matches =
-      top_move->move_type == MOVE_TYPE_EXCHANGE &&
-      top_move->tiles_played == inference->number_of_tiles_exchanged;
-  int recordable = is_within_equity_margin || number_exchanged_matches ||
-                   inference->bag_as_rack->empty;
+                                    (INFERENCE_EQUITY_EPSILON));
+  } else {
+    top_move = get_top_move(inference);
+    int is_within_equity_margin =
+        inference->actual_score + inference->equity_margin +
+            (INFERENCE_EQUITY_EPSILON) >=
+        top_move->equity;
+    int number_exchanged_matches =
+        top_move->move_type == MOVE_TYPE_EXCHANGE &&
+        top_move->tiles_played == inference->number_of_tiles_exchanged;
+    recordable = is_within_equity_margin || number_exchanged_matches ||
+                 inference->bag_as_rack->empty;
+  }
   if (recordable) {
     uint64_t number_of_draws_for_leave =
         get_number_of_draws_for_rack(inference->bag_as_rack, inference->leave);
@@ -318,6 +349,8 @@ void initialize_inference_for_evaluation(Inference *inference, Game *game,
   inference->number_of_tiles_exchanged = number_of_tiles_exchanged;
   inference->equity_margin = equity_margin;
   inference->current_rack_index = 0;
+  inference->leave_cache_hits = 0;
+  inference->leave_cache_misses = 0;
 
   inference->player_to_infer_index = player_to_infer_index;
   inference->klv = game->players[player_to_infer_index]->strategy_params->klv;
@@ -396,6 +429,8 @@ Inference *copy_inference(Inference *inference, ThreadControl *thread_control) {
   new_inference->initial_tiles_to_infer = inference->initial_tiles_to_infer;
   new_inference->equity_margin = inference->equity_margin;
   new_inference->current_rack_index = inference->current_rack_index;
+  new_inference->leave_cache_hits = 0;
+  new_inference->leave_cache_misses = 0;
 
   // Multithreading
   new_inference->thread_control = thread_control;
@@ -422,6 +457,8 @@ void add_inference(Inference *inference_1, Inference *inference_2) {
     add_inference_record(inference_1->rack_record, inference_2->rack_record,
                          inference_1->draw_and_leave_subtotals_size);
   }
+  inference_1->leave_cache_hits += inference_2->leave_cache_hits;
+  inference_1->leave_cache_misses += inference_2->leave_cache_misses;
   while (inference_2->leave_rack_list->count > 0) {
     LeaveRack *leave_rack_2 = pop_leave_rack(inference_2->leave_rack_list);
     insert_leave_rack(inference_1->leave_rack_list, leave_rack_2->leave,
@@ -500,17 +537,31 @@ void iterate_through_all_possible_leaves(Inference *inference,
   }
 }
 
+// Evaluates the leaves and records the leave cache
+// lookups the inference's generator made for them.
+void infer_leaves(Inference *inference, int multithreaded) {
+  uint64_t hits_before;
+  uint64_t misses_before;
+  get_leave_cache_stats(inference->game->gen, &hits_before, &misses_before);
+  iterate_through_all_possible_leaves(inference,
+                                      inference->initial_tiles_to_infer,
+                                      BLANK_MACHINE_LETTER, multithreaded);
+  uint64_t hits;
+  uint64_t misses;
+  get_leave_cache_stats(inference->game->gen, &hits, &misses);
+  inference->leave_cache_hits += hits - hits_before;
+  inference->leave_cache_misses += misses - misses_before;
+}
+
 void *infer_worker(void *uncasted_inference) {
   Inference *inference = (Inference *)uncasted_inference;
-  iterate_through_all_possible_leaves(
-      inference, inference->initial_tiles_to_infer, BLANK_MACHINE_LETTER, 1);
+  infer_leaves(inference, 1);
   reset_move_list(inference->game->gen->move_list);
   return NULL;
 }
 
 void infer_worker_single_threaded(Inference *inference) {
-  iterate_through_all_possible_leaves(
-      inference, inference->initial_tiles_to_infer, BLANK_MACHINE_LETTER, 0);
+  infer_leaves(inference, 0);
   reset_move_list(inference->game->gen->move_list);
 }
 
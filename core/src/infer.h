@@ -43,6 +43,9 @@ typedef struct Inference {
   uint64_t current_rack_index;
   int status;
   uint64_t total_racks_evaluated;
+  // The leave cache lookups made while evaluating the leaves
+  uint64_t leave_cache_hits;
+  uint64_t leave_cache_misses;
   // Multithreading fields
   uint64_t *shared_rack_index;
   pthread_mutex_t *shared_rack_index_lock;
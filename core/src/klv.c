@@ -91,6 +91,141 @@ float convert_little_endian_to_host(float little_endian_float) {
   }
 }
 
+uint32_t get_leave_rank_binomial(KLV *klv, int n, int k) {
+  return klv->leave_rank_binomials[n * (klv->leave_rank_max_length + 1) + k];
+}
+
+// Ranks the leave in colex order among the multisets of its size,
+// offset by the number of smaller multisets. Returns -1 if the leave
+// cannot be in the table.
+int64_t get_leave_rank(KLV *klv, Rack *leave) {
+  if (leave->number_of_letters > klv->leave_rank_max_length) {
+    return -1;
+  }
+  int64_t rank = klv->leave_rank_offsets[leave->number_of_letters];
+  int number_of_letters_ranked = 0;
+  int max_ml = leave->array_size;
+  if (max_ml > klv->leave_rank_alphabet_size) {
+    max_ml = klv->leave_rank_alphabet_size;
+  }
+  for (int ml = 0; ml < max_ml; ml++) {
+    for (int j = 0; j < leave->array[ml]; j++) {
+      // Adding the position makes the letters strictly increasing.
+      rank += get_leave_rank_binomial(klv, ml + number_of_letters_ranked,
+                                      number_of_letters_ranked + 1);
+      number_of_letters_ranked++;
+    }
+  }
+  if (number_of_letters_ranked != leave->number_of_letters) {
+    return -1;
+  }
+  return rank;
+}
+
+void find_leave_rank_dimensions(KLV *klv, uint32_t node_index, int length) {
+  for (uint32_t i = node_index;; i++) {
+    int ml = kwg_tile(klv->kwg, i);
+    if (ml + 1 > klv->leave_rank_alphabet_size) {
+      klv->leave_rank_alphabet_size = ml + 1;
+    }
+    if (length + 1 > klv->leave_rank_max_length) {
+      klv->leave_rank_max_length = length + 1;
+    }
+    uint32_t arc_index = kwg_arc_index(klv->kwg, i);
+    if (arc_index != 0) {
+      find_leave_rank_dimensions(klv, arc_index, length + 1);
+    }
+    if (kwg_is_end(klv->kwg, i)) {
+      break;
+    }
+  }
+}
+
+// Visits the leaves below the node in the same order as their indexes
+// in leave_values and returns the index of the next leave.
+uint32_t add_leaves_to_rank_table(KLV *klv, uint32_t node_index, Rack *leave,
+                                  uint32_t leave_index) {
+  for (uint32_t i = node_index;; i++) {
+    uint8_t ml = kwg_tile(klv->kwg, i);
+    add_letter_to_rack(leave, ml);
+    if (kwg_accepts(klv->kwg, i)) {
+      klv->leave_values_by_rank[get_leave_rank(klv, leave)] =
+          klv->leave_values[leave_index];
+      leave_index++;
+    }
+    uint32_t arc_index = kwg_arc_index(klv->kwg, i);
+    if (arc_index != 0) {
+      leave_index =
+          add_leaves_to_rank_table(klv, arc_index, leave, leave_index);
+    }
+    take_letter_from_rack(leave, ml);
+    if (kwg_is_end(klv->kwg, i)) {
+      break;
+    }
+  }
+  return leave_index;
+}
+
+void build_leave_rank_table(KLV *klv, uint32_t number_of_leaves) {
+  klv->leave_values_by_rank = NULL;
+  klv->leave_rank_binomials = NULL;
+  klv->leave_rank_alphabet_size = 0;
+  klv->leave_rank_max_length = 0;
+  uint32_t root_index = kwg_arc_index(klv->kwg, 0);
+  if (root_index == 0) {
+    return;
+  }
+  find_leave_rank_dimensions(klv, root_index, 0);
+  if (klv->leave_rank_max_length > RACK_SIZE) {
+    return;
+  }
+
+  // Pascal's triangle up to the largest value a ranked letter
+  // can take once its position is added.
+  int n = klv->leave_rank_alphabet_size + klv->leave_rank_max_length;
+  int k = klv->leave_rank_max_length;
+  klv->leave_rank_binomials = calloc(n * (k + 1), sizeof(uint32_t));
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= k && j <= i; j++) {
+      uint64_t binomial = 1;
+      if (j > 0 && j < i) {
+        binomial = (uint64_t)get_leave_rank_binomial(klv, i - 1, j - 1) +
+                   get_leave_rank_binomial(klv, i - 1, j);
+      }
+      if (binomial > MAX_LEAVE_RANK_TABLE_SIZE) {
+        binomial = MAX_LEAVE_RANK_TABLE_SIZE;
+      }
+      klv->leave_rank_binomials[i * (k + 1) + j] = binomial;
+    }
+  }
+
+  // There are C(a + l - 1, l) multisets of length l
+  // drawn from an alphabet of size a.
+  uint64_t table_size = 0;
+  for (int length = 0; length <= k; length++) {
+    klv->leave_rank_offsets[length] = table_size;
+    table_size += get_leave_rank_binomial(
+        klv, klv->leave_rank_alphabet_size + length - 1, length);
+    if (table_size > MAX_LEAVE_RANK_TABLE_SIZE) {
+      free(klv->leave_rank_binomials);
+      klv->leave_rank_binomials = NULL;
+      return;
+    }
+  }
+
+  // Leaves missing from the klv are worth nothing.
+  klv->leave_values_by_rank = calloc(table_size, sizeof(float));
+  Rack *leave = create_rack(klv->leave_rank_alphabet_size);
+  uint32_t number_of_leaves_added =
+      add_leaves_to_rank_table(klv, root_index, leave, 0);
+  destroy_rack(leave);
+  if (number_of_leaves_added != number_of_leaves) {
+    printf("klv has %d leaves but %d leave values\n", number_of_leaves_added,
+           number_of_leaves);
+    exit(EXIT_FAILURE);
+  }
+}
+
 void load_klv(KLV *klv, const char *klv_filename) {
   FILE *stream = stream_from_filename(klv_filename);
   if (stream == NULL) {
@@ -110,6 +245,13 @@ void load_klv(KLV *klv, const char *klv_filename) {
 
   klv->kwg = malloc(sizeof(KWG));
   klv->kwg->nodes = (uint32_t *)malloc(kwg_size * sizeof(uint32_t));
+  klv->kwg->number_of_nodes = kwg_size;
+  klv->kwg->is_mapped = 0;
+  klv->kwg->letter_masks = NULL;
+  klv->kwg->front_hooks = NULL;
+  klv->kwg->back_hooks = NULL;
+  klv->kwg->subtree_letter_masks = NULL;
+  klv->kwg->min_remaining_lengths = NULL;
   result = fread(klv->kwg->nodes, sizeof(uint32_t), kwg_size, stream);
   if (result != kwg_size) {
     printf("kwg nodes fread failure: %zd != %d\n", result, kwg_size);
@@ -146,6 +288,7 @@ void load_klv(KLV *klv, const char *klv_filename) {
   }
 
   count_words(klv, kwg_size);
+  build_leave_rank_table(klv, number_of_leaves);
 }
 
 KLV *create_klv(const char *klv_filename) {
@@ -157,6 +300,8 @@ KLV *create_klv(const char *klv_filename) {
 void destroy_klv(KLV *klv) {
   destroy_kwg(klv->kwg);
   free(klv->leave_values);
+  free(klv->leave_values_by_rank);
+  free(klv->leave_rank_binomials);
   free(klv->word_counts);
   free(klv);
 }
@@ -215,6 +360,13 @@ double get_leave_value(KLV *klv, Rack *leave) {
   if (klv == NULL) {
     return 0.0;
   }
+  if (klv->leave_values_by_rank) {
+    int64_t rank = get_leave_rank(klv, leave);
+    if (rank < 0) {
+      return 0.0;
+    }
+    return (double)klv->leave_values_by_rank[rank];
+  }
   int index = get_word_index_of(klv, kwg_arc_index(klv->kwg, 0), leave);
   if (index != -1) {
     return (double)klv->leave_values[index];
@@ -10,6 +10,15 @@ typedef struct KLV {
   KWG *kwg;
   int *word_counts;
   float *leave_values;
+  // The leave values indexed by the rank of the leave among all
+  // multisets of at most leave_rank_max_length letters, so that a
+  // leave is found without walking the kwg. NULL if the table
+  // would be too large, in which case the kwg is walked instead.
+  float *leave_values_by_rank;
+  int leave_rank_alphabet_size;
+  int leave_rank_max_length;
+  uint32_t leave_rank_offsets[(RACK_SIZE) + 1];
+  uint32_t *leave_rank_binomials;
 } KLV;
 
 KLV *create_klv(const char *klv_filename);
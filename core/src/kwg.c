@@ -3,14 +3,20 @@
 #else
 #include <endian.h>
 #endif
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "constants.h"
 #include "fileproxy.h"
 #include "kwg.h"
 #include "letter_distribution.h"
+#include "log.h"
 
-void load_kwg(KWG *kwg, const char *kwg_filename) {
+void load_kwg_copy(KWG *kwg, const char *kwg_filename) {
   FILE *stream = stream_from_filename(kwg_filename);
   if (stream == NULL) {
     perror(kwg_filename);
@@ -35,16 +41,282 @@ void load_kwg(KWG *kwg, const char *kwg_filename) {
     kwg->nodes[i] = le32toh(kwg->nodes[i]);
   }
   fclose(stream);
+  kwg->number_of_nodes = number_of_nodes;
+  kwg->is_mapped = 0;
 }
 
-KWG *create_kwg(const char *kwg_filename) {
+// Maps the kwg file read-only so that every process using the
+// same lexicon shares a single page cache copy of the nodes.
+// The file is little-endian, so the nodes can only be used in
+// place on little-endian hosts. Returns 0 if the file could not
+// be mapped, in which case the caller should fall back to a copy.
+int load_kwg_mmap(KWG *kwg, const char *kwg_filename) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // Precached files only exist in memory.
+  if (file_is_cached(kwg_filename)) {
+    return 0;
+  }
+  int fd = open(kwg_filename, O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    return 0;
+  }
+  void *mapped = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    return 0;
+  }
+  kwg->nodes = (uint32_t *)mapped;
+  kwg->number_of_nodes = file_stat.st_size / sizeof(uint32_t);
+  kwg->is_mapped = 1;
+  log_debug("mapped %s (%zu nodes)", kwg_filename, kwg->number_of_nodes);
+  return 1;
+#else
+  (void)kwg;
+  (void)kwg_filename;
+  return 0;
+#endif
+}
+
+int get_sibling_group_start(KWG *kwg, int node_index) {
+  while (node_index > 0 && !kwg_is_end(kwg, node_index - 1)) {
+    node_index--;
+  }
+  return node_index;
+}
+
+// Assigns new indexes to the whole sibling group containing
+// node_index and appends the group to the queue.
+void enqueue_sibling_group(KWG *kwg, int node_index, int *new_indexes,
+                           int *queue, int *queue_size, int *next_index) {
+  int start = get_sibling_group_start(kwg, node_index);
+  if (new_indexes[start] >= 0) {
+    return;
+  }
+  queue[(*queue_size)++] = start;
+  for (int i = start;; i++) {
+    new_indexes[i] = (*next_index)++;
+    if (kwg_is_end(kwg, i)) {
+      break;
+    }
+  }
+}
+
+// Renumbers the sibling groups in breadth-first order from the
+// roots so that the dense groups near the top of the GADDAG, which
+// every anchor visits, share cache lines. The dawg and gaddag root
+// pointers keep their indexes. Groups are moved whole, so arcs
+// that point into the middle of a shared group remain valid.
+void relayout_kwg(KWG *kwg) {
+  int number_of_nodes = kwg->number_of_nodes;
+  int *new_indexes = malloc(number_of_nodes * sizeof(int));
+  int *queue = malloc(number_of_nodes * sizeof(int));
+  for (int i = 0; i < number_of_nodes; i++) {
+    new_indexes[i] = -1;
+  }
+  int queue_size = 0;
+  int next_index = 0;
+  enqueue_sibling_group(kwg, 0, new_indexes, queue, &queue_size, &next_index);
+  enqueue_sibling_group(kwg, 1, new_indexes, queue, &queue_size, &next_index);
+  // Place the gaddag root siblings first since move generation
+  // starts every anchor there.
+  enqueue_sibling_group(kwg, kwg_get_root_node_index(kwg), new_indexes, queue,
+                        &queue_size, &next_index);
+  enqueue_sibling_group(kwg, kwg_arc_index(kwg, 0), new_indexes, queue,
+                        &queue_size, &next_index);
+  int queue_head = 0;
+  int unvisited_index = 0;
+  while (next_index < number_of_nodes) {
+    if (queue_head == queue_size) {
+      // Keep any groups unreachable from the roots.
+      while (new_indexes[unvisited_index] >= 0) {
+        unvisited_index++;
+      }
+      enqueue_sibling_group(kwg, unvisited_index, new_indexes, queue,
+                            &queue_size, &next_index);
+    }
+    for (int i = queue[queue_head++];; i++) {
+      int arc_index = kwg_arc_index(kwg, i);
+      if (arc_index != 0) {
+        enqueue_sibling_group(kwg, arc_index, new_indexes, queue, &queue_size,
+                              &next_index);
+      }
+      if (kwg_is_end(kwg, i)) {
+        break;
+      }
+    }
+  }
+
+  uint32_t *nodes = malloc(number_of_nodes * sizeof(uint32_t));
+  for (int i = 0; i < number_of_nodes; i++) {
+    uint32_t node = kwg->nodes[i];
+    int arc_index = kwg_arc_index(kwg, i);
+    nodes[new_indexes[i]] = (node & ~0x3fffff) | new_indexes[arc_index];
+  }
+
+  if (kwg->is_mapped) {
+    munmap(kwg->nodes, number_of_nodes * sizeof(uint32_t));
+  } else {
+    free(kwg->nodes);
+  }
+  kwg->nodes = nodes;
+  kwg->is_mapped = 0;
+  free(queue);
+  free(new_indexes);
+}
+
+void load_kwg(KWG *kwg, const char *kwg_filename, int load_mode) {
+  if (load_mode != KWG_LOAD_MODE_MMAP || !load_kwg_mmap(kwg, kwg_filename)) {
+    load_kwg_copy(kwg, kwg_filename);
+  }
+  kwg->letter_masks = NULL;
+  kwg->front_hooks = NULL;
+  kwg->back_hooks = NULL;
+  kwg->subtree_letter_masks = NULL;
+  kwg->min_remaining_lengths = NULL;
+  if (load_mode == KWG_LOAD_MODE_RELAYOUT) {
+    relayout_kwg(kwg);
+  }
+}
+
+// Builds the letter masks from the last sibling of each group
+// backwards. The index is left unbuilt if any sibling group is
+// not in strictly ascending tile order, since the popcount
+// offsets would then point at the wrong nodes.
+void build_kwg_letter_masks(KWG *kwg) {
+  uint64_t *letter_masks = malloc(kwg->number_of_nodes * sizeof(uint64_t));
+  for (size_t j = kwg->number_of_nodes; j > 0; j--) {
+    size_t i = j - 1;
+    int tile = kwg_tile(kwg, i);
+    if (tile >= 64) {
+      free(letter_masks);
+      return;
+    }
+    letter_masks[i] = (uint64_t)1 << tile;
+    if (!kwg_is_end(kwg, i)) {
+      if (i + 1 >= kwg->number_of_nodes || kwg_tile(kwg, i + 1) <= tile) {
+        free(letter_masks);
+        return;
+      }
+      letter_masks[i] |= letter_masks[i + 1];
+    }
+  }
+  kwg->letter_masks = letter_masks;
+}
+
+// Builds the hook sets from the last sibling of each group backwards,
+// then looks up the set of each separation arc. The hooks rely on the
+// sibling order checked by the letter masks, so they are only built
+// when the letter masks are.
+void build_kwg_hooks(KWG *kwg) {
+  if (!kwg->letter_masks) {
+    return;
+  }
+  uint64_t *front_hooks = malloc(kwg->number_of_nodes * sizeof(uint64_t));
+  for (size_t j = kwg->number_of_nodes; j > 0; j--) {
+    size_t i = j - 1;
+    front_hooks[i] = 0;
+    if (kwg_accepts(kwg, i)) {
+      front_hooks[i] = (uint64_t)1 << kwg_tile(kwg, i);
+    }
+    if (!kwg_is_end(kwg, i)) {
+      front_hooks[i] |= front_hooks[i + 1];
+    }
+  }
+  uint64_t *back_hooks = malloc(kwg->number_of_nodes * sizeof(uint64_t));
+  for (size_t i = 0; i < kwg->number_of_nodes; i++) {
+    back_hooks[i] = front_hooks[kwg_get_next_node_index(
+        kwg, i, SEPARATION_MACHINE_LETTER)];
+  }
+  kwg->front_hooks = front_hooks;
+  kwg->back_hooks = back_hooks;
+}
+
+void build_kwg_subtree_summary_at(KWG *kwg, size_t i, uint8_t *is_built) {
+  if (is_built[i]) {
+    return;
+  }
+  is_built[i] = 1;
+  int tile = kwg_tile(kwg, i);
+  // The separation letter does not take up a square.
+  int length = tile != SEPARATION_MACHINE_LETTER;
+  uint64_t letter_mask = (uint64_t)1 << tile;
+  int min_remaining_length = KWG_UNREACHABLE_LENGTH;
+  if (kwg_accepts(kwg, i)) {
+    min_remaining_length = length;
+  }
+  int arc_index = kwg_arc_index(kwg, i);
+  if (arc_index != 0) {
+    build_kwg_subtree_summary_at(kwg, arc_index, is_built);
+    letter_mask |= kwg->subtree_letter_masks[arc_index];
+    int arc_length = kwg->min_remaining_lengths[arc_index] + length;
+    if (arc_length < min_remaining_length) {
+      min_remaining_length = arc_length;
+    }
+  }
+  if (!kwg_is_end(kwg, i)) {
+    build_kwg_subtree_summary_at(kwg, i + 1, is_built);
+    letter_mask |= kwg->subtree_letter_masks[i + 1];
+    if (kwg->min_remaining_lengths[i + 1] < min_remaining_length) {
+      min_remaining_length = kwg->min_remaining_lengths[i + 1];
+    }
+  }
+  kwg->subtree_letter_masks[i] = letter_mask;
+  kwg->min_remaining_lengths[i] = min_remaining_length;
+}
+
+// Builds the subtree summaries used to stop searching below nodes
+// that the rack and the board cannot complete. Like the hooks, they
+// are only built when the letter masks are.
+void build_kwg_subtree_summaries(KWG *kwg) {
+  if (!kwg->letter_masks) {
+    return;
+  }
+  kwg->subtree_letter_masks =
+      malloc(kwg->number_of_nodes * sizeof(uint64_t));
+  kwg->min_remaining_lengths = malloc(kwg->number_of_nodes * sizeof(uint8_t));
+  uint8_t *is_built = calloc(kwg->number_of_nodes, sizeof(uint8_t));
+  for (size_t i = 0; i < kwg->number_of_nodes; i++) {
+    build_kwg_subtree_summary_at(kwg, i, is_built);
+  }
+  free(is_built);
+}
+
+KWG *create_kwg_with_load_mode(const char *kwg_filename, int load_mode) {
   KWG *kwg = malloc(sizeof(KWG));
-  load_kwg(kwg, kwg_filename);
+  load_kwg(kwg, kwg_filename, load_mode);
   return kwg;
 }
 
+void build_kwg_index(KWG *kwg) {
+  if (kwg->letter_masks) {
+    return;
+  }
+  build_kwg_letter_masks(kwg);
+  build_kwg_hooks(kwg);
+  build_kwg_subtree_summaries(kwg);
+}
+
+KWG *create_kwg(const char *kwg_filename) {
+  return create_kwg_with_load_mode(kwg_filename, KWG_LOAD_MODE_MMAP);
+}
+
 void destroy_kwg(KWG *kwg) {
-  free(kwg->nodes);
+  free(kwg->letter_masks);
+  free(kwg->front_hooks);
+  free(kwg->back_hooks);
+  free(kwg->subtree_letter_masks);
+  free(kwg->min_remaining_lengths);
+  if (kwg->is_mapped) {
+    munmap(kwg->nodes, kwg->number_of_nodes * sizeof(uint32_t));
+  } else {
+    free(kwg->nodes);
+  }
   free(kwg);
 }
 
@@ -53,32 +325,29 @@ extern inline int kwg_accepts(KWG *kwg, int node_index);
 extern inline int kwg_arc_index(KWG *kwg, int node_index);
 extern inline int kwg_tile(KWG *kwg, int node_index);
 extern inline int kwg_get_root_node_index(KWG *kwg);
+extern inline void kwg_prefetch_node(KWG *kwg, int node_index);
+extern inline uint64_t kwg_get_letter_mask(KWG *kwg, int node_index);
+extern inline int kwg_get_letter_node_index(KWG *kwg, int node_index,
+                                            int letter);
+extern inline int kwg_subtree_is_unplayable(KWG *kwg, int node_index,
+                                            uint64_t available_letters,
+                                            int number_of_letters);
 
 int kwg_get_next_node_index(KWG *kwg, int node_index, int letter) {
-  int i = node_index;
-  while (1) {
-    if (kwg_tile(kwg, i) == letter) {
-      return kwg_arc_index(kwg, i);
-    }
-    if (kwg_is_end(kwg, i)) {
-      return 0;
-    }
-    i++;
+  int i = kwg_get_letter_node_index(kwg, node_index, letter);
+  if (i < 0) {
+    return 0;
   }
+  return kwg_arc_index(kwg, i);
 }
 
 int kwg_in_letter_set(KWG *kwg, int letter, int node_index) {
   letter = get_unblanked_machine_letter(letter);
-  int i = node_index;
-  while (1) {
-    if (kwg_tile(kwg, i) == letter) {
-      return kwg_accepts(kwg, i);
-    }
-    if (kwg_is_end(kwg, i)) {
-      return 0;
-    }
-    i++;
+  int i = kwg_get_letter_node_index(kwg, node_index, letter);
+  if (i < 0) {
+    return 0;
   }
+  return kwg_accepts(kwg, i);
 }
 
 int kwg_get_letter_set(KWG *kwg, int node_index) {
@@ -96,3 +365,19 @@ int kwg_get_letter_set(KWG *kwg, int node_index) {
   }
   return ls;
 }
+
+uint64_t kwg_get_front_hooks(KWG *kwg, int node_index) {
+  if (kwg->front_hooks) {
+    return kwg->front_hooks[node_index];
+  }
+  return kwg_get_letter_set(kwg, node_index);
+}
+
+uint64_t kwg_get_back_hooks(KWG *kwg, int node_index) {
+  if (kwg->back_hooks) {
+    return kwg->back_hooks[node_index];
+  }
+  return kwg_get_letter_set(
+      kwg,
+      kwg_get_next_node_index(kwg, node_index, SEPARATION_MACHINE_LETTER));
+}
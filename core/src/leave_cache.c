@@ -0,0 +1,39 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "constants.h"
+#include "direct_mapped_cache.h"
+#include "klv.h"
+#include "leave_cache.h"
+
+LeaveCache *create_leave_cache(int capacity) {
+  // Entries without a klv are empty.
+  return create_direct_mapped_cache(capacity, sizeof(LeaveCacheEntry));
+}
+
+void destroy_leave_cache(LeaveCache *leave_cache) {
+  destroy_direct_mapped_cache(leave_cache);
+}
+
+// Returns the entry for the rack. If found is set to 0,
+// the entry holds another rack and can be overwritten.
+LeaveCacheEntry *lookup_leave_cache(LeaveCache *leave_cache, KLV *klv,
+                                    uint64_t rack_signature, int *found) {
+  // The signature counts letters in fixed bit fields, so it is
+  // mixed and the well mixed high bits select the entry.
+  uint64_t hash = (rack_signature ^ (uintptr_t)klv) * 0x9e3779b97f4a7c15;
+  LeaveCacheEntry *entry =
+      get_direct_mapped_cache_entry(leave_cache, hash >> 32);
+  *found = entry->klv == klv && entry->rack_signature == rack_signature;
+  record_direct_mapped_cache_lookup(leave_cache, *found);
+  return entry;
+}
+
+void set_leave_cache_entry(LeaveCacheEntry *entry, KLV *klv,
+                           uint64_t rack_signature, const double *leave_values,
+                           const double *best_leaves) {
+  entry->klv = klv;
+  entry->rack_signature = rack_signature;
+  memcpy(entry->leave_values, leave_values, sizeof(entry->leave_values));
+  memcpy(entry->best_leaves, best_leaves, sizeof(entry->best_leaves));
+}
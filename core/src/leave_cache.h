@@ -0,0 +1,31 @@
+#ifndef LEAVE_CACHE_H
+#define LEAVE_CACHE_H
+
+#include <stdint.h>
+
+#include "constants.h"
+#include "direct_mapped_cache.h"
+#include "klv.h"
+
+// The leave values of every subrack of a rack, indexed as in the
+// leave map, and the best leave value for each number of tiles kept.
+typedef struct LeaveCacheEntry {
+  KLV *klv;
+  uint64_t rack_signature;
+  double leave_values[1 << RACK_SIZE];
+  double best_leaves[(RACK_SIZE)];
+} LeaveCacheEntry;
+
+// Owned by a generator and looked up once per move generation,
+// so it only hits when the generator sees a rack again.
+typedef DirectMappedCache LeaveCache;
+
+LeaveCache *create_leave_cache(int capacity);
+void destroy_leave_cache(LeaveCache *leave_cache);
+LeaveCacheEntry *lookup_leave_cache(LeaveCache *leave_cache, KLV *klv,
+                                    uint64_t rack_signature, int *found);
+void set_leave_cache_entry(LeaveCacheEntry *entry, KLV *klv,
+                           uint64_t rack_signature, const double *leave_values,
+                           const double *best_leaves);
+
+#endif
@@ -21,7 +21,7 @@ void destroy_leave_map(LeaveMap *leave_map) {
 
 void take_letter_and_update_current_index(LeaveMap *leave_map, Rack *rack,
                                           uint8_t letter) {
-  take_letter_from_rack(rack, letter);
+  borrow_letter_from_rack(rack, letter);
   int base_index = leave_map->letter_base_index_map[letter];
   int offset = rack->array[letter];
   int bit_index = base_index + offset;
@@ -30,7 +30,7 @@ void take_letter_and_update_current_index(LeaveMap *leave_map, Rack *rack,
 
 void add_letter_and_update_current_index(LeaveMap *leave_map, Rack *rack,
                                          uint8_t letter) {
-  add_letter_to_rack(rack, letter);
+  return_letter_to_rack(rack, letter);
   int base_index = leave_map->letter_base_index_map[letter];
   int offset = rack->array[letter] - 1;
   int bit_index = base_index + offset;
@@ -55,3 +55,10 @@ void init_leave_map(LeaveMap *leave_map, Rack *rack) {
   }
   leave_map->current_index = (1 << current_base_index) - 1;
 }
+
+void copy_leave_values_into(LeaveMap *dst, LeaveMap *src) {
+  int number_of_values = 1 << RACK_SIZE;
+  for (int i = 0; i < number_of_values; i++) {
+    dst->leave_values[i] = src->leave_values[i];
+  }
+}
@@ -15,6 +15,7 @@ typedef struct LeaveMap {
 LeaveMap *create_leave_map(int rack_array_size);
 void destroy_leave_map(LeaveMap *LeaveMap);
 void init_leave_map(LeaveMap *leave_map, Rack *rack);
+void copy_leave_values_into(LeaveMap *dst, LeaveMap *src);
 void take_letter_and_update_current_index(LeaveMap *leave_map, Rack *rack,
                                           uint8_t letter);
 void add_letter_and_update_current_index(LeaveMap *leave_map, Rack *rack,
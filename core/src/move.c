@@ -8,25 +8,33 @@
 
 Move *create_move() { return malloc(sizeof(Move)); }
 
+// Doubles the room for moves, up to the capacity of the list.
+void grow_move_list(MoveList *ml) {
+  ml->number_of_allocated_moves *= 2;
+  if (ml->number_of_allocated_moves > ml->capacity) {
+    ml->number_of_allocated_moves = ml->capacity;
+  }
+  ml->moves =
+      realloc(ml->moves, sizeof(Move) * ml->number_of_allocated_moves);
+}
+
 MoveList *create_move_list(int capacity) {
   MoveList *ml = malloc(sizeof(MoveList));
   ml->count = 0;
   ml->capacity = capacity;
   ml->spare_move = create_move();
-  ml->moves = malloc(sizeof(Move *) * capacity);
-  for (int i = 0; i < capacity; i++) {
-    ml->moves[i] = create_move();
+  ml->number_of_allocated_moves = capacity;
+  if (ml->number_of_allocated_moves > MOVE_LIST_INITIAL_SIZE) {
+    ml->number_of_allocated_moves = MOVE_LIST_INITIAL_SIZE;
   }
-  ml->moves[0]->equity = INITIAL_TOP_MOVE_EQUITY;
+  ml->moves = malloc(sizeof(Move) * ml->number_of_allocated_moves);
+  ml->moves[0].equity = INITIAL_TOP_MOVE_EQUITY;
   return ml;
 }
 
 void destroy_move(Move *move) { free(move); }
 
 void destroy_move_list(MoveList *ml) {
-  for (int i = 0; i < ml->capacity; i++) {
-    destroy_move(ml->moves[i]);
-  }
   destroy_move(ml->spare_move);
   free(ml->moves);
   free(ml);
@@ -34,7 +42,7 @@ void destroy_move_list(MoveList *ml) {
 
 void reset_move_list(MoveList *ml) {
   ml->count = 0;
-  ml->moves[0]->equity = INITIAL_TOP_MOVE_EQUITY;
+  ml->moves[0].equity = INITIAL_TOP_MOVE_EQUITY;
 }
 
 int within_epsilon_for_equity(double a, double b) { return fabs(a - b) < 1e-6; }
@@ -57,50 +65,62 @@ int compare_moves(Move *move_1, Move *move_2) {
   if (move_1->tiles_length != move_2->tiles_length) {
     return move_1->tiles_length < move_2->tiles_length;
   }
-  for (int i = 0; i < move_1->tiles_length; i++) {
+  if (move_1->move_type != move_2->move_type) {
+    return move_1->move_type < move_2->move_type;
+  }
+  // Only the exchanged tiles of an exchange are set.
+  int number_of_tiles = move_1->tiles_length;
+  if (move_1->move_type == MOVE_TYPE_EXCHANGE) {
+    number_of_tiles = move_1->tiles_played;
+  }
+  for (int i = 0; i < number_of_tiles; i++) {
     if (move_1->tiles[i] != move_2->tiles[i]) {
       return move_1->tiles[i] < move_2->tiles[i];
     }
   }
+  // A play and its transposition across the diagonal have
+  // the same coordinates and tiles.
+  if (move_1->vertical != move_2->vertical) {
+    return move_1->vertical < move_2->vertical;
+  }
   return 0;
 }
 
+// Moves the move at index up the heap by shifting the parents
+// it beats down into the hole it leaves.
 void up_heapify(MoveList *ml, int index) {
-  Move *temp;
-  int parent_node = (index - 1) / 2;
-
-  if (compare_moves(ml->moves[parent_node], ml->moves[index])) {
-    temp = ml->moves[parent_node];
-    ml->moves[parent_node] = ml->moves[index];
-    ml->moves[index] = temp;
-    up_heapify(ml, parent_node);
+  Move move = ml->moves[index];
+  while (index > 0) {
+    int parent_node = (index - 1) / 2;
+    if (!compare_moves(&ml->moves[parent_node], &move)) {
+      break;
+    }
+    ml->moves[index] = ml->moves[parent_node];
+    index = parent_node;
   }
+  ml->moves[index] = move;
 }
 
 void down_heapify(MoveList *ml, int parent_node) {
-  int left = parent_node * 2 + 1;
-  int right = parent_node * 2 + 2;
-  int min;
-  Move *temp;
-
-  if (left >= ml->count || left < 0)
-    left = -1;
-  if (right >= ml->count || right < 0)
-    right = -1;
-
-  if (left != -1 && compare_moves(ml->moves[parent_node], ml->moves[left]))
-    min = left;
-  else
-    min = parent_node;
-  if (right != -1 && compare_moves(ml->moves[min], ml->moves[right]))
-    min = right;
-
-  if (min != parent_node) {
-    temp = ml->moves[min];
-    ml->moves[min] = ml->moves[parent_node];
-    ml->moves[parent_node] = temp;
-    down_heapify(ml, min);
+  Move move = ml->moves[parent_node];
+  while (1) {
+    int left = parent_node * 2 + 1;
+    int right = left + 1;
+    if (left >= ml->count) {
+      break;
+    }
+    int min = left;
+    if (right < ml->count &&
+        compare_moves(&ml->moves[left], &ml->moves[right])) {
+      min = right;
+    }
+    if (!compare_moves(&move, &ml->moves[min])) {
+      break;
+    }
+    ml->moves[parent_node] = ml->moves[min];
+    parent_node = min;
   }
+  ml->moves[parent_node] = move;
 }
 
 void set_move(Move *move, uint8_t strip[], int leftstrip, int rightstrip,
@@ -117,6 +137,9 @@ void set_move(Move *move, uint8_t strip[], int leftstrip, int rightstrip,
     for (int i = 0; i < move->tiles_length; i++) {
       move->tiles[i] = strip[leftstrip + i];
     }
+  } else {
+    // Keep passes comparable in compare_moves.
+    move->tiles[0] = 0;
   }
 }
 
@@ -150,10 +173,11 @@ void set_spare_move(MoveList *ml, uint8_t strip[], int leftstrip,
 void insert_spare_move(MoveList *ml, double equity) {
   ml->spare_move->equity = equity;
 
-  Move *swap = ml->moves[ml->count];
-  ml->moves[ml->count] = ml->spare_move;
-  ml->spare_move = swap;
+  if (ml->count == ml->number_of_allocated_moves) {
+    grow_move_list(ml);
+  }
 
+  ml->moves[ml->count] = *ml->spare_move;
   up_heapify(ml, ml->count);
   ml->count++;
 
@@ -164,39 +188,109 @@ void insert_spare_move(MoveList *ml, double equity) {
 
 void insert_spare_move_top_equity(MoveList *ml, double equity) {
   ml->spare_move->equity = equity;
-  if (compare_moves(ml->spare_move, ml->moves[0])) {
-    Move *swap = ml->moves[0];
-    ml->moves[0] = ml->spare_move;
-    ml->spare_move = swap;
+  if (compare_moves(ml->spare_move, &ml->moves[0])) {
+    ml->moves[0] = *ml->spare_move;
   }
 }
 
-Move *pop_move(MoveList *ml) {
-  if (ml->count == 1) {
-    ml->count--;
-    return ml->moves[0];
+// Keeps only the k best moves. Once the heap holds k moves, its
+// root is the worst of them, so a move that cannot beat the root
+// is rejected without touching the heap.
+void insert_spare_move_top_k(MoveList *ml, double equity, int k) {
+  ml->spare_move->equity = equity;
+  if (ml->count >= k && !compare_moves(ml->spare_move, &ml->moves[0])) {
+    return;
+  }
+  insert_spare_move(ml, equity);
+  if (ml->count > k) {
+    pop_move(ml);
   }
-  Move *swap = ml->spare_move;
-  ml->spare_move = ml->moves[0];
-  ml->moves[0] = ml->moves[ml->count - 1];
-  ml->moves[ml->count - 1] = swap;
+}
+
+void insert_spare_move_within_window(MoveList *ml, double equity,
+                                     double min_equity) {
+  if (equity < min_equity) {
+    return;
+  }
+  insert_spare_move(ml, equity);
+  pop_moves_below_equity(ml, min_equity);
+}
+
+void pop_moves_below_equity(MoveList *ml, double min_equity) {
+  while (ml->count > 0 && ml->moves[0].equity < min_equity) {
+    pop_move(ml);
+  }
+}
 
+// Removes the worst move and returns it. It is stored just past the
+// end of the heap, so it stays valid until the next insertion.
+Move *pop_move(MoveList *ml) {
   ml->count--;
+  if (ml->count == 0) {
+    return &ml->moves[0];
+  }
+  Move worst_move = ml->moves[0];
+  ml->moves[0] = ml->moves[ml->count];
+  ml->moves[ml->count] = worst_move;
   down_heapify(ml, 0);
-  return ml->spare_move;
+  return &ml->moves[ml->count];
 }
 
-void sort_moves(MoveList *ml) {
-  int number_of_moves = ml->count;
-  for (int i = 1; i < number_of_moves; i++) {
-    Move *move = pop_move(ml);
-    // Use a swap var to preserve the spare leave pointer
-    Move *swap = ml->moves[ml->count];
-    ml->moves[ml->count] = move;
-    ml->spare_move = swap;
+// Sifts down a max heap that is stored back to front in the move
+// list, so that heap index i is at moves[last - i]. Popping the best
+// move then fills the front of the list in descending order.
+void down_heapify_reversed(MoveList *ml, int last, int heap_size,
+                           int parent_node) {
+  Move *moves = ml->moves;
+  while (1) {
+    int left = parent_node * 2 + 1;
+    int right = left + 1;
+    int max = parent_node;
+    if (left < heap_size &&
+        compare_moves(&moves[last - left], &moves[last - max])) {
+      max = left;
+    }
+    if (right < heap_size &&
+        compare_moves(&moves[last - right], &moves[last - max])) {
+      max = right;
+    }
+    if (max == parent_node) {
+      return;
+    }
+    Move temp = moves[last - max];
+    moves[last - max] = moves[last - parent_node];
+    moves[last - parent_node] = temp;
+    parent_node = max;
   }
 }
 
+// Orders the best number_of_moves moves of the list into
+// moves[0] through moves[number_of_moves - 1]. The remaining moves
+// follow in no particular order. This takes linear time to build
+// the heap plus a logarithmic pop for each ordered move, so callers
+// that only read the first few moves do not pay for a full sort.
+// The list count is unchanged, but it is no longer a heap.
+void sort_top_moves(MoveList *ml, int number_of_moves) {
+  int last = ml->count - 1;
+  if (number_of_moves > ml->count) {
+    number_of_moves = ml->count;
+  }
+  for (int i = ml->count / 2 - 1; i >= 0; i--) {
+    down_heapify_reversed(ml, last, ml->count, i);
+  }
+  for (int i = 0; i < number_of_moves; i++) {
+    // The best remaining move is the root at moves[last] and
+    // the last heap node is at moves[i].
+    int heap_size = ml->count - i;
+    Move temp = ml->moves[i];
+    ml->moves[i] = ml->moves[last];
+    ml->moves[last] = temp;
+    down_heapify_reversed(ml, last, heap_size - 1, 0);
+  }
+}
+
+void sort_moves(MoveList *ml) { sort_top_moves(ml, ml->count); }
+
 void store_move_description(Move *move, char *placeholder,
                             LetterDistribution *ld) {
   char tiles[20];
@@ -6,23 +6,29 @@
 #include "board.h"
 #include "constants.h"
 
+// The small fields are packed so that on a 15x15 board
+// a move fits in 40 bytes.
 typedef struct Move {
-  uint8_t tiles[BOARD_DIM];
-  int score;
-  int row_start;
-  int col_start;
-  int tiles_played;
-  int tiles_length;
   double equity;
-  int vertical;
-  int move_type;
+  int score;
+  uint8_t tiles[BOARD_DIM];
+  int8_t row_start;
+  int8_t col_start;
+  int8_t tiles_played;
+  int8_t tiles_length;
+  int8_t vertical;
+  int8_t move_type;
 } Move;
 
 typedef struct MoveList {
   int count;
   int capacity;
   Move *spare_move;
-  Move **moves;
+  // The moves are stored by value in heap order. The array starts
+  // with room for MOVE_LIST_INITIAL_SIZE moves and doubles, up to
+  // the capacity, whenever the list grows past it.
+  Move *moves;
+  int number_of_allocated_moves;
 } MoveList;
 
 Move *create_move();
@@ -30,7 +36,9 @@ void copy_move(Move *src_move, Move *dest_move);
 void destroy_move(Move *move);
 MoveList *create_move_list(int capacity);
 void destroy_move_list(MoveList *ml);
+int compare_moves(Move *move_1, Move *move_2);
 void sort_moves(MoveList *ml);
+void sort_top_moves(MoveList *ml, int number_of_moves);
 void store_move_description(Move *move, char *placeholder,
                             LetterDistribution *ld);
 void set_spare_move(MoveList *ml, uint8_t strip[], int leftstrip,
@@ -38,6 +46,10 @@ void set_spare_move(MoveList *ml, uint8_t strip[], int leftstrip,
                     int tiles_played, int vertical, int move_type);
 void insert_spare_move(MoveList *ml, double equity);
 void insert_spare_move_top_equity(MoveList *ml, double equity);
+void insert_spare_move_top_k(MoveList *ml, double equity, int k);
+void insert_spare_move_within_window(MoveList *ml, double equity,
+                                     double min_equity);
+void pop_moves_below_equity(MoveList *ml, double min_equity);
 Move *pop_move(MoveList *ml);
 void reset_move_list(MoveList *ml);
 void set_move(Move *move, uint8_t strip[], int leftstrip, int rightstrip,
@@ -9,6 +9,7 @@
 #include "cross_set.h"
 #include "klv.h"
 #include "kwg.h"
+#include "leave_cache.h"
 #include "leave_map.h"
 #include "movegen.h"
 #include "player.h"
@@ -79,6 +80,47 @@ double get_spare_move_equity(Generator *gen, Player *player, Rack *opp_rack) {
          other_adjustments;
 }
 
+// Records the spare move for the top k and equity window recorders.
+void insert_spare_move_with_limits(Generator *gen, int play_recorder_type,
+                                   double equity) {
+  if (play_recorder_type == PLAY_RECORDER_TYPE_TOP_K) {
+    insert_spare_move_top_k(gen->move_list, equity, gen->max_recorded_moves);
+  } else {
+    if (equity > gen->best_recorded_equity) {
+      gen->best_recorded_equity = equity;
+    }
+    insert_spare_move_within_window(
+        gen->move_list, equity,
+        gen->best_recorded_equity - gen->recorded_equity_window);
+  }
+}
+
+// Returns whether anchors can be skipped once their shadow bound
+// falls below the equity a play needs to be recorded.
+int play_recorder_prunes_anchors(int play_recorder_type) {
+  return play_recorder_type != PLAY_RECORDER_TYPE_ALL &&
+         play_recorder_type != PLAY_RECORDER_TYPE_VISITOR;
+}
+
+// Returns the equity a play needs to be kept by the play recorder,
+// which is compared against the shadow bound of each anchor.
+double get_min_recordable_equity(Generator *gen, int play_recorder_type) {
+  switch (play_recorder_type) {
+  case PLAY_RECORDER_TYPE_TOP_EQUITY:
+    return gen->move_list->moves[0].equity;
+  case PLAY_RECORDER_TYPE_TOP_K:
+    if (gen->move_list->count >= gen->max_recorded_moves) {
+      return gen->move_list->moves[0].equity;
+    }
+    return INITIAL_TOP_MOVE_EQUITY;
+  case PLAY_RECORDER_TYPE_EQUITY_WINDOW:
+    return gen->best_recorded_equity - gen->recorded_equity_window;
+  case PLAY_RECORDER_TYPE_EQUITY_THRESHOLD:
+    return gen->equity_threshold;
+  }
+  return INITIAL_TOP_MOVE_EQUITY;
+}
+
 void record_play(Generator *gen, Player *player, Rack *opp_rack, int leftstrip,
                  int rightstrip, int move_type) {
   int start_row = gen->current_row_index;
@@ -86,8 +128,9 @@ void record_play(Generator *gen, Player *player, Rack *opp_rack, int leftstrip,
   int start_col = leftstrip;
   int row = start_row;
   int col = start_col;
+  int vertical = gen->vertical;
 
-  if (gen->vertical) {
+  if (vertical) {
     int temp = row;
     row = col;
     col = temp;
@@ -109,28 +152,67 @@ void record_play(Generator *gen, Player *player, Rack *opp_rack, int leftstrip,
     }
     tiles_played = rightstrip;
     strip = gen->exchange_strip;
+    // Exchanges are found before any row is searched, so give
+    // them fixed coordinates to keep them comparable.
+    row = 0;
+    col = 0;
+    vertical = 0;
+  }
+
+  if (player->strategy_params->play_recorder_type ==
+      PLAY_RECORDER_TYPE_VISITOR) {
+    // Exchanges are already stored from the start of the strip.
+    int number_of_tiles = tiles_played;
+    if (move_type == MOVE_TYPE_PLAY) {
+      strip += leftstrip;
+      number_of_tiles = rightstrip - leftstrip + 1;
+    }
+    gen->move_visitor(strip, number_of_tiles, row, col, vertical,
+                      tiles_played, move_type, score,
+                      get_current_value(gen->leave_map),
+                      gen->move_visitor_data);
+    return;
   }
 
   // Set the move to more easily handle equity calculations
   set_spare_move(gen->move_list, strip, leftstrip, rightstrip, score, row, col,
-                 tiles_played, gen->vertical, move_type);
-
-  if (player->strategy_params->play_recorder_type == PLAY_RECORDER_TYPE_ALL) {
-    double equity;
-    if (player->strategy_params->move_sorting == SORT_BY_EQUITY) {
-      equity = get_spare_move_equity(gen, player, opp_rack);
-    } else {
-      equity = score;
+                 tiles_played, vertical, move_type);
+
+  if (player->strategy_params->play_recorder_type ==
+      PLAY_RECORDER_TYPE_EQUITY_THRESHOLD) {
+    double equity = get_spare_move_equity(gen, player, opp_rack);
+    if (equity > gen->equity_threshold) {
+      insert_spare_move_top_equity(gen->move_list, equity);
+      gen->move_list->count = 1;
+      gen->equity_threshold_exceeded = 1;
     }
-    insert_spare_move(gen->move_list, equity);
-  } else {
+    return;
+  }
+
+  if (player->strategy_params->play_recorder_type ==
+      PLAY_RECORDER_TYPE_TOP_EQUITY) {
     insert_spare_move_top_equity(gen->move_list,
                                  get_spare_move_equity(gen, player, opp_rack));
+    return;
+  }
+
+  double equity;
+  if (player->strategy_params->move_sorting == SORT_BY_EQUITY) {
+    equity = get_spare_move_equity(gen, player, opp_rack);
+  } else {
+    equity = score;
+  }
+  int play_recorder_type = player->strategy_params->play_recorder_type;
+  if (play_recorder_type == PLAY_RECORDER_TYPE_ALL) {
+    insert_spare_move(gen->move_list, equity);
+  } else {
+    insert_spare_move_with_limits(gen, play_recorder_type, equity);
   }
 }
 
 void generate_exchange_moves(Generator *gen, Player *player, uint8_t ml,
-                             int stripidx, int add_exchange) {
+                             int stripidx, int add_exchange,
+                             int leave_values_cached) {
   while (ml < (gen->letter_distribution->size) &&
          player->rack->array[ml] == 0) {
     ml++;
@@ -142,24 +224,29 @@ void generate_exchange_moves(Generator *gen, Player *player, uint8_t ml,
     // Ignore the empty exchange case for full racks
     // to avoid out of bounds errors for the best_leaves array
     if (player->rack->number_of_letters < RACK_SIZE) {
-      double current_value =
-          get_leave_value(player->strategy_params->klv, player->rack);
-      set_current_value(gen->leave_map, current_value);
-      if (current_value > gen->best_leaves[player->rack->number_of_letters]) {
-        gen->best_leaves[player->rack->number_of_letters] = current_value;
+      if (!leave_values_cached) {
+        double current_value =
+            get_leave_value(player->strategy_params->klv, player->rack);
+        set_current_value(gen->leave_map, current_value);
+        if (current_value >
+            gen->best_leaves[player->rack->number_of_letters]) {
+          gen->best_leaves[player->rack->number_of_letters] = current_value;
+        }
       }
       if (add_exchange) {
         record_play(gen, player, NULL, 0, stripidx, MOVE_TYPE_EXCHANGE);
       }
     }
   } else {
-    generate_exchange_moves(gen, player, ml + 1, stripidx, add_exchange);
+    generate_exchange_moves(gen, player, ml + 1, stripidx, add_exchange,
+                            leave_values_cached);
     int num_this = player->rack->array[ml];
     for (int i = 0; i < num_this; i++) {
       gen->exchange_strip[stripidx] = ml;
       stripidx += 1;
       take_letter_and_update_current_index(gen->leave_map, player->rack, ml);
-      generate_exchange_moves(gen, player, ml + 1, stripidx, add_exchange);
+      generate_exchange_moves(gen, player, ml + 1, stripidx, add_exchange,
+                            leave_values_cached);
     }
     for (int i = 0; i < num_this; i++) {
       add_letter_and_update_current_index(gen->leave_map, player->rack, ml);
@@ -168,8 +255,17 @@ void generate_exchange_moves(Generator *gen, Player *player, uint8_t ml,
 }
 
 void load_row_letter_cache(Generator *gen, int row) {
+  gen->row_letters = 0;
+  gen->row_tiles_before[0] = 0;
   for (int col = 0; col < BOARD_DIM; col++) {
-    gen->row_letter_cache[col] = get_letter(gen->board, row, col);
+    uint8_t letter = get_letter(gen->board, row, col);
+    gen->row_letter_cache[col] = letter;
+    gen->row_tiles_before[col + 1] = gen->row_tiles_before[col];
+    if (letter != ALPHABET_EMPTY_SQUARE_MARKER) {
+      gen->row_letters |= (uint64_t)1
+                          << get_unblanked_machine_letter(letter);
+      gen->row_tiles_before[col + 1]++;
+    }
   }
 }
 
@@ -181,9 +277,203 @@ int is_empty_cache(Generator *gen, int col) {
   return get_letter_cache(gen, col) == ALPHABET_EMPTY_SQUARE_MARKER;
 }
 
+void take_tile_for_play(Generator *gen, Player *player, uint8_t tile) {
+  take_letter_and_update_current_index(gen->leave_map, player->rack, tile);
+  if (player->rack->array[tile] == 0) {
+    gen->rack_letters &= ~((uint64_t)1 << tile);
+  }
+  gen->tiles_played++;
+}
+
+void return_tile_from_play(Generator *gen, Player *player, uint8_t tile) {
+  gen->tiles_played--;
+  add_letter_and_update_current_index(gen->leave_map, player->rack, tile);
+  gen->rack_letters |= (uint64_t)1 << tile;
+}
+
+// Returns the number of tiles on the board in the current row
+// from start_col through end_col.
+int get_row_tile_count(Generator *gen, int start_col, int end_col) {
+  return gen->row_tiles_before[end_col + 1] - gen->row_tiles_before[start_col];
+}
+
+// Returns whether no word can be completed below the node with the
+// tiles left on the rack and the tiles on the board in this row. The
+// word can only take number_of_squares more squares, number_of_tiles
+// of which are already on the board.
+int subtree_is_unplayable(Generator *gen, Player *player,
+                          uint32_t node_index, int number_of_squares,
+                          int number_of_tiles) {
+  uint64_t available_letters = gen->rack_letters | gen->row_letters;
+  if (gen->rack_letters & ((uint64_t)1 << BLANK_MACHINE_LETTER)) {
+    available_letters = ~(uint64_t)0;
+  }
+  int number_of_letters = number_of_squares;
+  if (number_of_letters > player->rack->number_of_letters + number_of_tiles) {
+    number_of_letters = player->rack->number_of_letters + number_of_tiles;
+  }
+  if (kwg_subtree_is_unplayable(player->strategy_params->kwg, node_index,
+                                available_letters, number_of_letters)) {
+#ifdef MOVEGEN_STATS
+    gen->subtrees_pruned++;
+#endif
+    return 1;
+  }
+  return 0;
+}
+
+// Returns whether none of the ways to designate the blanks of the
+// play in the strip can be kept by the play recorder. The strip must
+// hold the undesignated letters, which score at least as much as any
+// designation, and the rack must hold the tiles of the play.
+int blank_designations_are_unrecordable(Generator *gen, Player *player,
+                                        int leftstrip, int rightstrip) {
+  int play_recorder_type = player->strategy_params->play_recorder_type;
+  // Without leave values or with the opening placement adjustment,
+  // the equity depends on more than the score and the leave.
+  if (!play_recorder_prunes_anchors(play_recorder_type) ||
+      player->strategy_params->move_sorting != SORT_BY_EQUITY ||
+      gen->bag->last_tile_index < 0 || gen->board->tiles_played == 0) {
+    return 0;
+  }
+  int max_score =
+      score_move(gen->board, gen->strip, leftstrip, rightstrip,
+                 gen->current_row_index, leftstrip, gen->tiles_played,
+                 !gen->vertical, get_cross_set_index(gen, player->index),
+                 gen->letter_distribution);
+  int leave_size = player->rack->number_of_letters - gen->tiles_played;
+  double max_equity = max_score + gen->best_leaves[leave_size];
+  int bag_plus_rack_size =
+      (gen->bag->last_tile_index + 1) - gen->tiles_played + RACK_SIZE;
+  if (bag_plus_rack_size < PREENDGAME_ADJUSTMENT_VALUES_LENGTH) {
+    max_equity += gen->preendgame_adjustment_values[bag_plus_rack_size];
+  }
+  return max_equity < get_min_recordable_equity(gen, play_recorder_type);
+}
+
+void record_blank_designations(Generator *gen, Player *player,
+                               Rack *opp_rack, int col, int leftstrip,
+                               int rightstrip) {
+  while (col <= rightstrip && gen->strip[col] == PLAYED_THROUGH_MARKER) {
+    col++;
+  }
+  if (col > rightstrip) {
+    record_play(gen, player, opp_rack, leftstrip, rightstrip, MOVE_TYPE_PLAY);
+    return;
+  }
+  uint8_t ml = gen->strip[col];
+  if (player->rack->array[ml] > 0) {
+    take_letter_and_update_current_index(gen->leave_map, player->rack, ml);
+    record_blank_designations(gen, player, opp_rack, col + 1, leftstrip,
+                              rightstrip);
+    add_letter_and_update_current_index(gen->leave_map, player->rack, ml);
+  }
+  if (player->rack->array[BLANK_MACHINE_LETTER] > 0 &&
+      !gen->equity_threshold_exceeded) {
+    take_letter_and_update_current_index(gen->leave_map, player->rack,
+                                         BLANK_MACHINE_LETTER);
+    gen->strip[col] = get_blanked_machine_letter(ml);
+    record_blank_designations(gen, player, opp_rack, col + 1, leftstrip,
+                              rightstrip);
+    gen->strip[col] = ml;
+    add_letter_and_update_current_index(gen->leave_map, player->rack,
+                                        BLANK_MACHINE_LETTER);
+  }
+}
+
+// Records a play found with deferred blank designations. The search
+// uses a blank only once the rack is out of the letter, so the rest of
+// the designations are found by putting the tiles back on the rack and
+// choosing between the letter and a blank for each tile again.
+void record_play_with_blanks(Generator *gen, Player *player, Rack *opp_rack,
+                             int leftstrip, int rightstrip) {
+  int number_of_blanks = player->rack->array[BLANK_MACHINE_LETTER];
+  for (int col = leftstrip; col <= rightstrip; col++) {
+    if (gen->strip[col] != PLAYED_THROUGH_MARKER &&
+        is_blanked(gen->strip[col])) {
+      number_of_blanks++;
+    }
+  }
+  if (!gen->defer_blank_designations || number_of_blanks == 0) {
+    record_play(gen, player, opp_rack, leftstrip, rightstrip, MOVE_TYPE_PLAY);
+    return;
+  }
+
+  uint8_t found_strip[(BOARD_DIM)];
+  memcpy(found_strip, gen->strip, sizeof(found_strip));
+  for (int col = leftstrip; col <= rightstrip; col++) {
+    uint8_t tile = gen->strip[col];
+    if (tile == PLAYED_THROUGH_MARKER) {
+      continue;
+    }
+    if (is_blanked(tile)) {
+      gen->strip[col] = get_unblanked_machine_letter(tile);
+      tile = BLANK_MACHINE_LETTER;
+    }
+    add_letter_and_update_current_index(gen->leave_map, player->rack, tile);
+  }
+
+  if (!blank_designations_are_unrecordable(gen, player, leftstrip,
+                                           rightstrip)) {
+    record_blank_designations(gen, player, opp_rack, leftstrip, leftstrip,
+                              rightstrip);
+  }
+
+  memcpy(gen->strip, found_strip, sizeof(found_strip));
+  for (int col = leftstrip; col <= rightstrip; col++) {
+    uint8_t tile = gen->strip[col];
+    if (tile == PLAYED_THROUGH_MARKER) {
+      continue;
+    }
+    if (is_blanked(tile)) {
+      tile = BLANK_MACHINE_LETTER;
+    }
+    take_letter_and_update_current_index(gen->leave_map, player->rack, tile);
+  }
+}
+
+void recursive_gen_with_tile(Generator *gen, int col, Player *player,
+                             Rack *opp_rack, int ml, int i, int leftstrip,
+                             int rightstrip, int unique_play) {
+  int next_node_index = kwg_arc_index(player->strategy_params->kwg, i);
+  int accepts = kwg_accepts(player->strategy_params->kwg, i);
+  if (gen->defer_blank_designations) {
+    // Use the letter if there is one left and
+    // leave the other designations for recording.
+    uint8_t tile = ml;
+    uint8_t letter = ml;
+    if (player->rack->array[ml] == 0) {
+      tile = BLANK_MACHINE_LETTER;
+      letter = get_blanked_machine_letter(ml);
+    }
+    take_tile_for_play(gen, player, tile);
+    go_on(gen, col, letter, player, opp_rack, next_node_index, accepts,
+          leftstrip, rightstrip, unique_play);
+    return_tile_from_play(gen, player, tile);
+    return;
+  }
+  if (player->rack->array[ml] > 0) {
+    take_tile_for_play(gen, player, ml);
+    go_on(gen, col, ml, player, opp_rack, next_node_index, accepts, leftstrip,
+          rightstrip, unique_play);
+    return_tile_from_play(gen, player, ml);
+  }
+  // check blank
+  if (player->rack->array[0] > 0) {
+    take_tile_for_play(gen, player, BLANK_MACHINE_LETTER);
+    go_on(gen, col, get_blanked_machine_letter(ml), player, opp_rack,
+          next_node_index, accepts, leftstrip, rightstrip, unique_play);
+    return_tile_from_play(gen, player, BLANK_MACHINE_LETTER);
+  }
+}
+
 void recursive_gen(Generator *gen, int col, Player *player, Rack *opp_rack,
                    uint32_t node_index, int leftstrip, int rightstrip,
                    int unique_play) {
+  KWG *kwg = player->strategy_params->kwg;
+#ifdef MOVEGEN_STATS
+  gen->subtrees_searched++;
+#endif
   int cs_direction;
   uint8_t current_letter = get_letter_cache(gen, col);
   if (gen->vertical) {
@@ -198,48 +488,40 @@ void recursive_gen(Generator *gen, int col, Player *player, Rack *opp_rack,
     int raw = get_unblanked_machine_letter(current_letter);
     int next_node_index = 0;
     int accepts = 0;
-    for (int i = node_index;; i++) {
-      if (kwg_tile(player->strategy_params->kwg, i) == raw) {
-        next_node_index = kwg_arc_index(player->strategy_params->kwg, i);
-        accepts = kwg_accepts(player->strategy_params->kwg, i);
-        break;
-      }
-      if (kwg_is_end(player->strategy_params->kwg, i)) {
-        break;
-      }
+    int i = kwg_get_letter_node_index(kwg, node_index, raw);
+    if (i >= 0) {
+      next_node_index = kwg_arc_index(kwg, i);
+      accepts = kwg_accepts(kwg, i);
     }
     go_on(gen, col, current_letter, player, opp_rack, next_node_index, accepts,
           leftstrip, rightstrip, unique_play);
+  } else if (!player->rack->empty && kwg->letter_masks) {
+    // Only visit the siblings allowed by the cross set, skipping
+    // the separation letter.
+    uint64_t letter_mask = kwg_get_letter_mask(kwg, node_index);
+    uint64_t possible_letters = letter_mask & cross_set & ~(uint64_t)1;
+    int has_blank = player->rack->array[0] != 0;
+    while (possible_letters) {
+      int ml = __builtin_ctzll(possible_letters);
+      possible_letters &= possible_letters - 1;
+      if (!has_blank && player->rack->array[ml] == 0) {
+        continue;
+      }
+      int i = node_index +
+              __builtin_popcountll(letter_mask & (((uint64_t)1 << ml) - 1));
+      recursive_gen_with_tile(gen, col, player, opp_rack, ml, i, leftstrip,
+                              rightstrip, unique_play);
+    }
   } else if (!player->rack->empty) {
     for (int i = node_index;; i++) {
-      int ml = kwg_tile(player->strategy_params->kwg, i);
+      int ml = kwg_tile(kwg, i);
       if (ml != 0 &&
           (player->rack->array[ml] != 0 || player->rack->array[0] != 0) &&
           allowed(cross_set, ml)) {
-        int next_node_index = kwg_arc_index(player->strategy_params->kwg, i);
-        int accepts = kwg_accepts(player->strategy_params->kwg, i);
-        if (player->rack->array[ml] > 0) {
-          take_letter_and_update_current_index(gen->leave_map, player->rack,
-                                               ml);
-          gen->tiles_played++;
-          go_on(gen, col, ml, player, opp_rack, next_node_index, accepts,
-                leftstrip, rightstrip, unique_play);
-          gen->tiles_played--;
-          add_letter_and_update_current_index(gen->leave_map, player->rack, ml);
-        }
-        // check blank
-        if (player->rack->array[0] > 0) {
-          take_letter_and_update_current_index(gen->leave_map, player->rack,
-                                               BLANK_MACHINE_LETTER);
-          gen->tiles_played++;
-          go_on(gen, col, get_blanked_machine_letter(ml), player, opp_rack,
-                next_node_index, accepts, leftstrip, rightstrip, unique_play);
-          gen->tiles_played--;
-          add_letter_and_update_current_index(gen->leave_map, player->rack,
-                                              BLANK_MACHINE_LETTER);
-        }
+        recursive_gen_with_tile(gen, col, player, opp_rack, ml, i, leftstrip,
+                                rightstrip, unique_play);
       }
-      if (kwg_is_end(player->strategy_params->kwg, i)) {
+      if (kwg_is_end(kwg, i)) {
         break;
       }
     }
@@ -249,6 +531,14 @@ void recursive_gen(Generator *gen, int col, Player *player, Rack *opp_rack,
 void go_on(Generator *gen, int current_col, uint8_t L, Player *player,
            Rack *opp_rack, uint32_t new_node_index, int accepts, int leftstrip,
            int rightstrip, int unique_play) {
+  // Unwind the remaining recursion once the threshold is exceeded.
+  if (gen->equity_threshold_exceeded) {
+    return;
+  }
+  // Start loading the child siblings while the play is recorded.
+  if (new_node_index != 0) {
+    kwg_prefetch_node(player->strategy_params->kwg, new_node_index);
+  }
   if (current_col <= gen->current_anchor_col) {
     if (!is_empty_cache(gen, current_col)) {
       gen->strip[current_col] = PLAYED_THROUGH_MARKER;
@@ -268,13 +558,42 @@ void go_on(Generator *gen, int current_col, uint8_t L, Player *player,
 
     if (accepts && no_letter_directly_left && gen->tiles_played > 0 &&
         (unique_play || gen->tiles_played > 1)) {
-      record_play(gen, player, opp_rack, leftstrip, rightstrip, MOVE_TYPE_PLAY);
+      record_play_with_blanks(gen, player, opp_rack, leftstrip, rightstrip);
     }
 
     if (new_node_index == 0) {
       return;
     }
 
+    // The word can still extend left up to the square after the
+    // previous anchor and, after the separation arc, right of the
+    // anchor to the edge of the board.
+    int left_start_col = 0;
+    if (gen->last_anchor_col < gen->current_anchor_col) {
+      left_start_col = gen->last_anchor_col + 1;
+    }
+    int right_start_col = gen->current_anchor_col + 1;
+    int number_of_right_squares = BOARD_DIM - right_start_col;
+    int number_of_right_tiles = 0;
+    if (number_of_right_squares > 0) {
+      number_of_right_tiles =
+          get_row_tile_count(gen, right_start_col, BOARD_DIM - 1);
+    }
+    int number_of_left_squares = current_col - left_start_col;
+    int number_of_left_tiles = 0;
+    if (number_of_left_squares > 0) {
+      number_of_left_tiles =
+          get_row_tile_count(gen, left_start_col, current_col - 1);
+    }
+
+    // The separation arc is one of the siblings, so
+    // this also covers the plays extending to the right.
+    if (subtree_is_unplayable(gen, player, new_node_index,
+                              number_of_left_squares + number_of_right_squares,
+                              number_of_left_tiles + number_of_right_tiles)) {
+      return;
+    }
+
     if (current_col > 0 && current_col - 1 != gen->last_anchor_col) {
       recursive_gen(gen, current_col - 1, player, opp_rack, new_node_index,
                     leftstrip, rightstrip, unique_play);
@@ -284,7 +603,10 @@ void go_on(Generator *gen, int current_col, uint8_t L, Player *player,
         kwg_get_next_node_index(player->strategy_params->kwg, new_node_index,
                                 SEPARATION_MACHINE_LETTER);
     if (separation_node_index != 0 && no_letter_directly_left &&
-        gen->current_anchor_col < BOARD_DIM - 1) {
+        gen->current_anchor_col < BOARD_DIM - 1 &&
+        !subtree_is_unplayable(gen, player, separation_node_index,
+                               number_of_right_squares,
+                               number_of_right_tiles)) {
       recursive_gen(gen, gen->current_anchor_col + 1, player, opp_rack,
                     separation_node_index, leftstrip, rightstrip, unique_play);
     }
@@ -307,10 +629,13 @@ void go_on(Generator *gen, int current_col, uint8_t L, Player *player,
 
     if (accepts && no_letter_directly_right && gen->tiles_played > 0 &&
         (unique_play || gen->tiles_played > 1)) {
-      record_play(gen, player, opp_rack, leftstrip, rightstrip, MOVE_TYPE_PLAY);
+      record_play_with_blanks(gen, player, opp_rack, leftstrip, rightstrip);
     }
 
-    if (new_node_index != 0 && current_col < BOARD_DIM - 1) {
+    if (new_node_index != 0 && current_col < BOARD_DIM - 1 &&
+        !subtree_is_unplayable(
+            gen, player, new_node_index, BOARD_DIM - 1 - current_col,
+            get_row_tile_count(gen, current_col + 1, BOARD_DIM - 1))) {
       recursive_gen(gen, current_col + 1, player, opp_rack, new_node_index,
                     leftstrip, rightstrip, unique_play);
     }
@@ -603,16 +928,20 @@ void shadow_play_for_anchor(Generator *gen, int col, Player *player) {
                 gen->highest_shadow_equity);
 }
 
-void shadow_by_orientation(Generator *gen, Player *player, int dir) {
+void shadow_by_orientation(Generator *gen, Player *player) {
   for (int row = 0; row < BOARD_DIM; row++) {
+    uint32_t anchors = get_line_anchors(gen->board, row);
+    if (!anchors) {
+      continue;
+    }
     gen->current_row_index = row;
     gen->last_anchor_col = INITIAL_LAST_ANCHOR_COL;
     load_row_letter_cache(gen, gen->current_row_index);
-    for (int col = 0; col < BOARD_DIM; col++) {
-      if (get_anchor(gen->board, row, col, dir)) {
-        shadow_play_for_anchor(gen, col, player);
-        gen->last_anchor_col = col;
-      }
+    while (anchors) {
+      int col = __builtin_ctz(anchors);
+      anchors &= anchors - 1;
+      shadow_play_for_anchor(gen, col, player);
+      gen->last_anchor_col = col;
     }
   }
 }
@@ -631,61 +960,358 @@ void set_descending_tile_scores(Generator *gen, Player *player) {
   }
 }
 
-void generate_moves(Generator *gen, Player *player, Rack *opp_rack,
-                    int add_exchange) {
-  // Reset the best leaves
+void generate_moves_for_anchor(Generator *gen, Anchor *anchor, Player *player,
+                               Rack *opp_rack) {
+  gen->current_anchor_col = anchor->col;
+  gen->current_row_index = anchor->row;
+  gen->last_anchor_col = anchor->last_anchor_col;
+  gen->vertical = anchor->vertical;
+  set_transpose(gen->board, anchor->transpose_state);
+  load_row_letter_cache(gen, gen->current_row_index);
+  gen->rack_letters = 0;
+  for (int i = 0; i < player->rack->array_size; i++) {
+    if (player->rack->array[i] > 0) {
+      gen->rack_letters |= (uint64_t)1 << i;
+    }
+  }
+  recursive_gen(gen, gen->current_anchor_col, player, opp_rack,
+                kwg_get_root_node_index(player->strategy_params->kwg),
+                gen->current_anchor_col, gen->current_anchor_col,
+                !gen->vertical);
+}
+
+void update_shared_best_equity(MovegenSharedState *shared_state,
+                               double equity) {
+  double best_equity = atomic_load(&shared_state->best_equity);
+  while (equity > best_equity &&
+         !atomic_compare_exchange_weak(&shared_state->best_equity,
+                                       &best_equity, equity)) {
+  }
+}
+
+// Claims anchors from the shared anchor list until it is exhausted
+// or until the remaining anchors cannot make the play recorder. When
+// recording only the top equity play, the best play found by any
+// thread is used. The other limited recorders prune with the plays
+// this thread has found, which keeps a superset of what the merged
+// list needs.
+void generate_moves_for_shared_anchors(Generator *gen, Player *player,
+                                       MovegenSharedState *shared_state) {
+  int play_recorder_type = player->strategy_params->play_recorder_type;
+  int top_equity = play_recorder_type == PLAY_RECORDER_TYPE_TOP_EQUITY;
+  AnchorList *anchor_list = shared_state->anchor_list;
+  while (1) {
+    int i = atomic_fetch_add(&shared_state->next_anchor_index, 1);
+    if (i >= anchor_list->count) {
+      break;
+    }
+    double highest_possible_equity =
+        anchor_list->anchors[i]->highest_possible_equity;
+    if (top_equity && highest_possible_equity <
+                          atomic_load(&shared_state->best_equity)) {
+      break;
+    }
+    if (!top_equity && play_recorder_prunes_anchors(play_recorder_type) &&
+        highest_possible_equity <
+            get_min_recordable_equity(gen, play_recorder_type)) {
+      break;
+    }
+    generate_moves_for_anchor(gen, anchor_list->anchors[i], player,
+                              shared_state->opp_rack);
+    if (top_equity) {
+      update_shared_best_equity(shared_state,
+                                gen->move_list->moves[0].equity);
+    }
+  }
+}
+
+MovegenWorker *create_movegen_worker(Generator *gen) {
+  MovegenWorker *movegen_worker = malloc(sizeof(MovegenWorker));
+  movegen_worker->gen = copy_generator(gen, gen->move_list->capacity);
+  movegen_worker->rack = create_rack(gen->letter_distribution->size);
+  movegen_worker->shared_state = NULL;
+  return movegen_worker;
+}
+
+void destroy_movegen_worker(MovegenWorker *movegen_worker) {
+  destroy_generator(movegen_worker->gen);
+  destroy_rack(movegen_worker->rack);
+  free(movegen_worker);
+}
+
+void destroy_movegen_workers(Generator *gen) {
+  if (gen->workers == NULL) {
+    return;
+  }
+  for (int i = 0; i < gen->number_of_workers; i++) {
+    destroy_movegen_worker(gen->workers[i]);
+  }
+  free(gen->workers);
+  gen->workers = NULL;
+  gen->number_of_workers = 0;
+}
+
+// A capacity of 0 disables the leave cache.
+void set_leave_cache_capacity(Generator *gen, int capacity) {
+  if (gen->leave_cache) {
+    destroy_leave_cache(gen->leave_cache);
+    gen->leave_cache = NULL;
+  }
+  gen->leave_cache_capacity = capacity;
+}
+
+// Gets the leave cache lookups of the generator so far,
+// which are 0 until the leave cache is created.
+void get_leave_cache_stats(Generator *gen, uint64_t *hits, uint64_t *misses) {
+  *hits = 0;
+  *misses = 0;
+  if (gen->leave_cache) {
+    *hits = gen->leave_cache->hits;
+    *misses = gen->leave_cache->misses;
+  }
+}
+
+void set_move_visitor(Generator *gen, MoveVisitor move_visitor,
+                      void *move_visitor_data) {
+  gen->move_visitor = move_visitor;
+  gen->move_visitor_data = move_visitor_data;
+}
+
+void set_movegen_threads(Generator *gen, int number_of_threads) {
+  if (number_of_threads < 1) {
+    number_of_threads = 1;
+  }
+  gen->number_of_threads = number_of_threads;
+}
+
+// Brings the worker generator to the state of gen after the
+// exchanges and shadow plays have been generated. The board of the
+// worker is a view of the board of gen, which is not written during
+// generation, and only the size of the bag is read from the bag.
+void prepare_movegen_worker(MovegenWorker *movegen_worker, Generator *gen,
+                            Player *player,
+                            MovegenSharedState *shared_state) {
+  Generator *worker_gen = movegen_worker->gen;
+  view_board_into(worker_gen->board, gen->board);
+  worker_gen->bag->last_tile_index = gen->bag->last_tile_index;
+  copy_rack_into(movegen_worker->rack, player->rack);
+  movegen_worker->player = *player;
+  movegen_worker->player.rack = movegen_worker->rack;
+  init_leave_map(worker_gen->leave_map, movegen_worker->rack);
+  copy_leave_values_into(worker_gen->leave_map, gen->leave_map);
+  reset_move_list(worker_gen->move_list);
+  worker_gen->max_recorded_moves = gen->max_recorded_moves;
+  worker_gen->recorded_equity_window = gen->recorded_equity_window;
+  worker_gen->best_recorded_equity = gen->best_recorded_equity;
+  worker_gen->tiles_played = 0;
+  worker_gen->subtrees_searched = 0;
+  worker_gen->subtrees_pruned = 0;
+  worker_gen->apply_placement_adjustment = gen->apply_placement_adjustment;
+  worker_gen->defer_blank_designations = gen->defer_blank_designations;
   for (int i = 0; i < (RACK_SIZE); i++) {
-    gen->best_leaves[i] = (double)(INITIAL_TOP_MOVE_EQUITY);
+    worker_gen->best_leaves[i] = gen->best_leaves[i];
   }
+  for (int i = 0; i < PREENDGAME_ADJUSTMENT_VALUES_LENGTH; i++) {
+    worker_gen->preendgame_adjustment_values[i] =
+        gen->preendgame_adjustment_values[i];
+  }
+  movegen_worker->shared_state = shared_state;
+}
 
-  init_leave_map(gen->leave_map, player->rack);
-  if (player->rack->number_of_letters < RACK_SIZE) {
-    set_current_value(
-        gen->leave_map,
-        get_leave_value(player->strategy_params->klv, player->rack));
+void *movegen_worker(void *uncasted_movegen_worker) {
+  MovegenWorker *movegen_worker = (MovegenWorker *)uncasted_movegen_worker;
+  generate_moves_for_shared_anchors(movegen_worker->gen,
+                                    &movegen_worker->player,
+                                    movegen_worker->shared_state);
+  return NULL;
+}
+
+// Moves the plays found by a worker into the move list of gen.
+// Move order is fully determined by compare_moves, so the merged
+// list does not depend on how the anchors were split.
+void merge_worker_moves(Generator *gen, MovegenWorker *movegen_worker,
+                        int play_recorder_type) {
+  MoveList *move_list = gen->move_list;
+  MoveList *worker_move_list = movegen_worker->gen->move_list;
+  if (play_recorder_type == PLAY_RECORDER_TYPE_TOP_EQUITY) {
+    if (compare_moves(&worker_move_list->moves[0], &move_list->moves[0])) {
+      copy_move(&worker_move_list->moves[0], &move_list->moves[0]);
+    }
   } else {
-    set_current_value(gen->leave_map, INITIAL_TOP_MOVE_EQUITY);
+    // Moves are stored by value in their list, so
+    // they are copied into the list of gen.
+    for (int i = 0; i < worker_move_list->count; i++) {
+      Move *move = &worker_move_list->moves[i];
+      copy_move(move, move_list->spare_move);
+      if (play_recorder_type == PLAY_RECORDER_TYPE_ALL) {
+        insert_spare_move(move_list, move->equity);
+      } else {
+        insert_spare_move_with_limits(gen, play_recorder_type, move->equity);
+      }
+    }
+  }
+  reset_move_list(worker_move_list);
+}
+
+void generate_moves_for_anchors_in_parallel(Generator *gen, Player *player,
+                                            Rack *opp_rack) {
+  int number_of_workers = gen->number_of_threads - 1;
+  if (gen->number_of_workers < number_of_workers) {
+    gen->workers =
+        realloc(gen->workers, sizeof(MovegenWorker *) * number_of_workers);
+    for (int i = gen->number_of_workers; i < number_of_workers; i++) {
+      gen->workers[i] = create_movegen_worker(gen);
+    }
+    gen->number_of_workers = number_of_workers;
   }
 
-  // Set the best leaves and maybe add exchanges.
-  generate_exchange_moves(gen, player, 0, 0, add_exchange);
+  MovegenSharedState shared_state;
+  atomic_init(&shared_state.next_anchor_index, 0);
+  atomic_init(&shared_state.best_equity, gen->move_list->moves[0].equity);
+  shared_state.opp_rack = opp_rack;
+  shared_state.anchor_list = gen->anchor_list;
+
+  pthread_t *worker_ids = malloc(sizeof(pthread_t) * number_of_workers);
+  for (int i = 0; i < number_of_workers; i++) {
+    prepare_movegen_worker(gen->workers[i], gen, player, &shared_state);
+    pthread_create(&worker_ids[i], NULL, movegen_worker, gen->workers[i]);
+  }
+
+  generate_moves_for_shared_anchors(gen, player, &shared_state);
+
+  for (int i = 0; i < number_of_workers; i++) {
+    pthread_join(worker_ids[i], NULL);
+  }
+  // The equity window is relative to the best play of any thread.
+  for (int i = 0; i < number_of_workers; i++) {
+    if (gen->workers[i]->gen->best_recorded_equity >
+        gen->best_recorded_equity) {
+      gen->best_recorded_equity = gen->workers[i]->gen->best_recorded_equity;
+    }
+  }
+  for (int i = 0; i < number_of_workers; i++) {
+    merge_worker_moves(gen, gen->workers[i],
+                       player->strategy_params->play_recorder_type);
+#ifdef MOVEGEN_STATS
+    gen->subtrees_searched += gen->workers[i]->gen->subtrees_searched;
+    gen->subtrees_pruned += gen->workers[i]->gen->subtrees_pruned;
+#endif
+  }
+  if (player->strategy_params->play_recorder_type ==
+      PLAY_RECORDER_TYPE_EQUITY_WINDOW) {
+    pop_moves_below_equity(gen->move_list, gen->best_recorded_equity -
+                                               gen->recorded_equity_window);
+  }
+  free(worker_ids);
+}
+
+void generate_moves(Generator *gen, Player *player, Rack *opp_rack,
+                    int add_exchange) {
+  gen->best_recorded_equity = INITIAL_TOP_MOVE_EQUITY;
+  gen->equity_threshold_exceeded = 0;
+  gen->subtrees_searched = 0;
+  gen->subtrees_pruned = 0;
+
+  init_leave_map(gen->leave_map, player->rack);
+  KLV *klv = player->strategy_params->klv;
+  LeaveCacheEntry *leave_cache_entry = NULL;
+  uint64_t rack_signature = 0;
+  int leave_values_cached = 0;
+  if (gen->leave_cache_capacity > 0) {
+    if (!gen->leave_cache) {
+      gen->leave_cache = create_leave_cache(gen->leave_cache_capacity);
+    }
+    rack_signature = get_rack_signature(player->rack);
+    leave_cache_entry =
+        lookup_leave_cache(gen->leave_cache, klv, rack_signature,
+                           &leave_values_cached);
+  }
+
+  if (leave_values_cached) {
+    memcpy(gen->leave_map->leave_values, leave_cache_entry->leave_values,
+           sizeof(leave_cache_entry->leave_values));
+    memcpy(gen->best_leaves, leave_cache_entry->best_leaves,
+           sizeof(gen->best_leaves));
+    // The leave values are already set, so the subracks
+    // only need to be visited to add the exchanges.
+    if (add_exchange) {
+      generate_exchange_moves(gen, player, 0, 0, add_exchange, 1);
+    }
+  } else {
+    // Reset the best leaves
+    for (int i = 0; i < (RACK_SIZE); i++) {
+      gen->best_leaves[i] = (double)(INITIAL_TOP_MOVE_EQUITY);
+    }
+
+    if (player->rack->number_of_letters < RACK_SIZE) {
+      set_current_value(gen->leave_map, get_leave_value(klv, player->rack));
+    } else {
+      set_current_value(gen->leave_map, INITIAL_TOP_MOVE_EQUITY);
+    }
+
+    // Set the best leaves and maybe add exchanges.
+    generate_exchange_moves(gen, player, 0, 0, add_exchange, 0);
+    if (leave_cache_entry) {
+      set_leave_cache_entry(leave_cache_entry, klv, rack_signature,
+                            gen->leave_map->leave_values, gen->best_leaves);
+    }
+  }
+  if (gen->equity_threshold_exceeded) {
+    return;
+  }
 
   reset_anchor_list(gen->anchor_list);
   set_descending_tile_scores(gen, player);
 
   for (int dir = 0; dir < 2; dir++) {
     gen->vertical = dir % 2 != 0;
-    shadow_by_orientation(gen, player, dir);
+    shadow_by_orientation(gen, player);
     transpose(gen->board);
   }
 
   // Reset the reused generator fields
   gen->tiles_played = 0;
 
-  for (int i = 0; i < gen->anchor_list->count; i++) {
-    if (player->strategy_params->play_recorder_type ==
-            PLAY_RECORDER_TYPE_TOP_EQUITY &&
-        gen->anchor_list->anchors[i]->highest_possible_equity <
-            gen->move_list->moves[0]->equity) {
-      break;
+  // The visitor is not required to be thread safe and the equity
+  // threshold recorder stops at its first play, so both are always
+  // run on this thread.
+  int play_recorder_type = player->strategy_params->play_recorder_type;
+  if (gen->number_of_threads > 1 && gen->anchor_list->count > 1 &&
+      play_recorder_type != PLAY_RECORDER_TYPE_VISITOR &&
+      play_recorder_type != PLAY_RECORDER_TYPE_EQUITY_THRESHOLD) {
+    generate_moves_for_anchors_in_parallel(gen, player, opp_rack);
+  } else {
+    for (int i = 0; i < gen->anchor_list->count; i++) {
+      if (gen->equity_threshold_exceeded) {
+        break;
+      }
+      if (play_recorder_prunes_anchors(play_recorder_type) &&
+          gen->anchor_list->anchors[i]->highest_possible_equity <
+              get_min_recordable_equity(gen, play_recorder_type)) {
+        break;
+      }
+      generate_moves_for_anchor(gen, gen->anchor_list->anchors[i], player,
+                                opp_rack);
     }
-    gen->current_anchor_col = gen->anchor_list->anchors[i]->col;
-    gen->current_row_index = gen->anchor_list->anchors[i]->row;
-    gen->last_anchor_col = gen->anchor_list->anchors[i]->last_anchor_col;
-    gen->vertical = gen->anchor_list->anchors[i]->vertical;
-    set_transpose(gen->board, gen->anchor_list->anchors[i]->transpose_state);
-    load_row_letter_cache(gen, gen->current_row_index);
-    recursive_gen(gen, gen->current_anchor_col, player, opp_rack,
-                  kwg_get_root_node_index(player->strategy_params->kwg),
-                  gen->current_anchor_col, gen->current_anchor_col,
-                  !gen->vertical);
   }
 
   reset_transpose(gen->board);
 
   // Add the pass move
-  if (player->strategy_params->play_recorder_type == PLAY_RECORDER_TYPE_ALL ||
-      gen->move_list->moves[0]->equity < PASS_MOVE_EQUITY) {
+  if (play_recorder_type == PLAY_RECORDER_TYPE_VISITOR ||
+      play_recorder_type == PLAY_RECORDER_TYPE_EQUITY_THRESHOLD) {
+    return;
+  }
+  if (player->strategy_params->play_recorder_type ==
+          PLAY_RECORDER_TYPE_TOP_K ||
+      player->strategy_params->play_recorder_type ==
+          PLAY_RECORDER_TYPE_EQUITY_WINDOW) {
+    set_spare_move_as_pass(gen->move_list);
+    insert_spare_move_with_limits(
+        gen, player->strategy_params->play_recorder_type, PASS_MOVE_EQUITY);
+  } else if (player->strategy_params->play_recorder_type ==
+                 PLAY_RECORDER_TYPE_ALL ||
+      gen->move_list->moves[0].equity < PASS_MOVE_EQUITY) {
     set_spare_move_as_pass(gen->move_list);
     insert_spare_move(gen->move_list, PASS_MOVE_EQUITY);
   } else if (player->strategy_params->play_recorder_type ==
@@ -727,9 +1353,24 @@ Generator *create_generator(Config *config) {
   generator->vertical = 0;
   generator->last_anchor_col = 0;
   generator->kwgs_are_distinct = !config->kwg_is_shared;
+  generator->number_of_threads = 1;
+  generator->number_of_workers = 0;
+  generator->workers = NULL;
+  generator->max_recorded_moves = 1;
+  generator->recorded_equity_window = 0;
+  generator->best_recorded_equity = INITIAL_TOP_MOVE_EQUITY;
+  generator->equity_threshold = 0;
+  generator->equity_threshold_exceeded = 0;
+  generator->move_visitor = NULL;
+  generator->move_visitor_data = NULL;
+  generator->leave_cache = NULL;
+  generator->leave_cache_capacity = config->leave_cache_capacity;
 
   // On by default
   generator->apply_placement_adjustment = 1;
+  generator->subtrees_searched = 0;
+  generator->subtrees_pruned = 0;
+  generator->defer_blank_designations = config->defer_blank_designations;
 
   generator->exchange_strip =
       (uint8_t *)malloc(config->letter_distribution->size * sizeof(uint8_t));
@@ -753,8 +1394,23 @@ Generator *copy_generator(Generator *gen, int move_list_size) {
   new_generator->vertical = 0;
   new_generator->last_anchor_col = 0;
   new_generator->kwgs_are_distinct = gen->kwgs_are_distinct;
+  new_generator->number_of_threads = 1;
+  new_generator->number_of_workers = 0;
+  new_generator->workers = NULL;
+  new_generator->max_recorded_moves = gen->max_recorded_moves;
+  new_generator->recorded_equity_window = gen->recorded_equity_window;
+  new_generator->best_recorded_equity = INITIAL_TOP_MOVE_EQUITY;
+  new_generator->equity_threshold = 0;
+  new_generator->equity_threshold_exceeded = 0;
+  new_generator->move_visitor = gen->move_visitor;
+  new_generator->move_visitor_data = gen->move_visitor_data;
+  new_generator->leave_cache = NULL;
+  new_generator->leave_cache_capacity = gen->leave_cache_capacity;
 
   new_generator->apply_placement_adjustment = gen->apply_placement_adjustment;
+  new_generator->subtrees_searched = 0;
+  new_generator->subtrees_pruned = 0;
+  new_generator->defer_blank_designations = gen->defer_blank_designations;
 
   new_generator->exchange_strip =
       (uint8_t *)malloc(gen->letter_distribution->size * sizeof(uint8_t));
@@ -765,11 +1421,15 @@ Generator *copy_generator(Generator *gen, int move_list_size) {
 }
 
 void destroy_generator(Generator *gen) {
+  destroy_movegen_workers(gen);
   destroy_bag(gen->bag);
   destroy_board(gen->board);
   destroy_move_list(gen->move_list);
   destroy_anchor_list(gen->anchor_list);
   destroy_leave_map(gen->leave_map);
+  if (gen->leave_cache) {
+    destroy_leave_cache(gen->leave_cache);
+  }
   free(gen->exchange_strip);
   free(gen);
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef MOVEGEN_H
 #define MOVEGEN_H
 
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 
 #include "anchor.h"
@@ -10,12 +12,27 @@
 #include "constants.h"
 #include "klv.h"
 #include "kwg.h"
+#include "leave_cache.h"
 #include "leave_map.h"
 #include "letter_distribution.h"
 #include "move.h"
 #include "player.h"
 #include "rack.h"
 
+struct MovegenWorker;
+
+// Called for each play found by the visitor play recorder instead of
+// storing it in the move list. The move is the number_of_tiles tiles
+// starting at tiles. For plays, these run from the start square and
+// include a PLAYED_THROUGH_MARKER for each square already on the board.
+// For exchanges, they are the tiles exchanged, where a blank is
+// BLANK_MACHINE_LETTER. Row and col are the untransposed start square.
+// The pass is not visited.
+typedef void (*MoveVisitor)(const uint8_t *tiles, int number_of_tiles,
+                            int row, int col, int vertical, int tiles_played,
+                            int move_type, int score, double leave_value,
+                            void *visitor_data);
+
 typedef struct Generator {
   int current_row_index;
   int current_anchor_col;
@@ -25,8 +42,24 @@ typedef struct Generator {
   int number_of_plays;
   int apply_placement_adjustment;
   int kwgs_are_distinct;
+  // When set, a tile that could come from either the rack or a blank
+  // is searched once, and the designations are only enumerated for
+  // the words that are found.
+  int defer_blank_designations;
 
   uint8_t row_letter_cache[(BOARD_DIM)];
+  // The letters on the board in the current row and the letters
+  // left on the rack, used to prune subtrees of the kwg.
+  uint64_t row_letters;
+  // The number of tiles on the board in the current row
+  // before each column.
+  int row_tiles_before[(BOARD_DIM) + 1];
+  uint64_t rack_letters;
+  // Calls to recursive_gen and subtrees skipped by pruning in the
+  // last generation. These are only counted in builds with
+  // MOVEGEN_STATS defined, since they sit in the innermost loop.
+  uint64_t subtrees_searched;
+  uint64_t subtrees_pruned;
   uint8_t strip[(BOARD_DIM)];
   uint8_t *exchange_strip;
   double preendgame_adjustment_values[PREENDGAME_ADJUSTMENT_VALUES_LENGTH];
@@ -38,6 +71,11 @@ typedef struct Generator {
   LeaveMap *leave_map;
   LetterDistribution *letter_distribution;
 
+  // Leave values and best leaves by rack, created on the first
+  // generation unless the capacity is 0.
+  LeaveCache *leave_cache;
+  int leave_cache_capacity;
+
   // Shadow plays
   int current_left_col;
   int current_right_col;
@@ -48,8 +86,51 @@ typedef struct Generator {
   int descending_tile_scores[(RACK_SIZE)];
   double best_leaves[(RACK_SIZE)];
   AnchorList *anchor_list;
+
+  // Limits for the top k and equity window play recorders.
+  int max_recorded_moves;
+  double recorded_equity_window;
+  double best_recorded_equity;
+
+  // The equity threshold play recorder stops generating once it
+  // records a play with equity above the threshold.
+  double equity_threshold;
+  int equity_threshold_exceeded;
+
+  // Callback for the visitor play recorder.
+  MoveVisitor move_visitor;
+  void *move_visitor_data;
+
+  // Parallel generation over the anchor list. The calling thread
+  // acts as the first worker, so only number_of_threads - 1
+  // workers are used. Workers are created when a parallel generation
+  // first needs them and are kept until the generator is destroyed,
+  // so changing the number of threads does not recreate them.
+  int number_of_threads;
+  int number_of_workers;
+  struct MovegenWorker **workers;
 } Generator;
 
+// State shared by the threads generating moves for one position.
+// Anchors are claimed in descending order of highest possible equity.
+typedef struct MovegenSharedState {
+  atomic_int next_anchor_index;
+  // Best equity found so far by any thread, used to prune anchors
+  // when only the top equity play is recorded.
+  _Atomic double best_equity;
+  Rack *opp_rack;
+  AnchorList *anchor_list;
+} MovegenSharedState;
+
+typedef struct MovegenWorker {
+  Generator *gen;
+  // Copy of the player on turn with its own rack, since the
+  // rack is modified while generating.
+  Player player;
+  Rack *rack;
+  MovegenSharedState *shared_state;
+} MovegenWorker;
+
 Generator *create_generator(Config *config);
 Generator *copy_generator(Generator *gen, int move_list_size);
 void destroy_generator(Generator *gen);
@@ -59,6 +140,11 @@ void recursive_gen(Generator *gen, int col, Player *player, Rack *opp_rack,
                    uint32_t node_index, int leftstrip, int rightstrip,
                    int unique_play);
 void reset_generator(Generator *gen);
+void set_movegen_threads(Generator *gen, int number_of_threads);
+void set_move_visitor(Generator *gen, MoveVisitor move_visitor,
+                      void *move_visitor_data);
+void set_leave_cache_capacity(Generator *gen, int capacity);
+void get_leave_cache_stats(Generator *gen, uint64_t *hits, uint64_t *misses);
 void load_row_letter_cache(Generator *gen, int row);
 int get_cross_set_index(Generator *gen, int player_index);
 
@@ -5,59 +5,90 @@
 
 #include "letter_distribution.h"
 #include "rack.h"
+#include "zobrist.h"
+
+extern inline uint64_t get_signature_byte_mask(int k);
+extern inline uint64_t add_to_rack_signature(uint64_t signature,
+                                             int number_of_letters,
+                                             uint8_t letter);
+extern inline uint64_t remove_from_rack_signature(uint64_t signature,
+                                                  int number_of_letters,
+                                                  uint8_t letter);
+extern inline void take_letter_from_rack(Rack *rack, uint8_t letter);
+extern inline void add_letter_to_rack(Rack *rack, uint8_t letter);
+extern inline void borrow_letter_from_rack(Rack *rack, uint8_t letter);
+extern inline void return_letter_to_rack(Rack *rack, uint8_t letter);
 
 void reset_rack(Rack *rack) {
-  for (int i = 0; i < (rack->array_size); i++) {
-    rack->array[i] = 0;
-  }
+  memset(rack->array, 0, sizeof(rack->array));
   rack->empty = 1;
   rack->number_of_letters = 0;
+  rack->hash = 0;
+  rack->signature = 0;
 }
 
 Rack *create_rack(int array_size) {
+  if (array_size > MAX_ALPHABET_SIZE) {
+    printf("rack alphabet size %d exceeds the maximum of %d\n", array_size,
+           MAX_ALPHABET_SIZE);
+    exit(EXIT_FAILURE);
+  }
   Rack *rack = malloc(sizeof(Rack));
   rack->array_size = array_size;
-  rack->array = (int *)malloc(rack->array_size * sizeof(int));
   reset_rack(rack);
   return rack;
 }
 
 Rack *copy_rack(Rack *rack) {
   Rack *new_rack = malloc(sizeof(Rack));
-  new_rack->array = (int *)malloc(rack->array_size * sizeof(int));
-  new_rack->array_size = rack->array_size;
-  reset_rack(new_rack);
   copy_rack_into(new_rack, rack);
   return new_rack;
 }
 
-void copy_rack_into(Rack *dst, Rack *src) {
-  for (int i = 0; i < src->array_size; i++) {
-    dst->array[i] = src->array[i];
-  }
-  dst->number_of_letters = src->number_of_letters;
-  dst->empty = src->empty;
-}
+void copy_rack_into(Rack *dst, Rack *src) { *dst = *src; }
+
+void destroy_rack(Rack *rack) { free(rack); }
 
-void destroy_rack(Rack *rack) {
-  free(rack->array);
-  free(rack);
+uint64_t compute_rack_signature(Rack *rack) {
+  uint64_t signature = 0;
+  for (int i = 0; i < rack->array_size; i++) {
+    for (int j = 0; j < rack->array[i]; j++) {
+      signature = (signature << 8) | (uint64_t)(i + 1);
+    }
+  }
+  return signature;
 }
 
-void take_letter_from_rack(Rack *rack, uint8_t letter) {
+// Takes a letter the rack does not hold, leaving its count negative.
+// The signature is not updated since it is undefined until the count
+// is restored.
+void take_letter_not_on_rack(Rack *rack, uint8_t letter) {
   rack->array[letter]--;
   rack->number_of_letters--;
+  rack->hash -= get_rack_letter_key(letter);
   if (rack->number_of_letters == 0) {
     rack->empty = 1;
   }
 }
 
-void add_letter_to_rack(Rack *rack, uint8_t letter) {
+// Adds back a letter whose count is negative and rebuilds the
+// signature once no count is negative anymore.
+void return_letter_not_on_rack(Rack *rack, uint8_t letter) {
   rack->array[letter]++;
   rack->number_of_letters++;
+  rack->hash += get_rack_letter_key(letter);
   if (rack->empty == 1) {
     rack->empty = 0;
   }
+  if (rack->number_of_letters > RACK_SIGNATURE_MAX_LETTERS) {
+    return;
+  }
+  for (int i = 0; i < rack->array_size; i++) {
+    if (rack->array[i] < 0) {
+      return;
+    }
+  }
+  rack->signature = compute_rack_signature(rack);
 }
 
 int score_on_rack(LetterDistribution *letter_distribution, Rack *rack) {
@@ -106,4 +137,8 @@ bool racks_are_equal(Rack *rack1, Rack *rack2) {
     }
   }
   return true;
-}
\ No newline at end of file
+}
+
+// Distinct racks of at most RACK_SIGNATURE_MAX_LETTERS letters
+// have distinct signatures.
+uint64_t get_rack_signature(Rack *rack) { return rack->signature; }
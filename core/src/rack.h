@@ -6,15 +6,25 @@
 
 #include "constants.h"
 #include "letter_distribution.h"
+#include "zobrist.h"
 
+// The counts are stored inline, so a rack is copied with a single
+// struct assignment and needs no allocation of its own. They are
+// signed because inference checks for counts that drop below zero.
 typedef struct Rack {
   int array_size;
-  int *array;
+  int8_t array[MAX_ALPHABET_SIZE];
   int empty;
   int number_of_letters;
+  // The sum of the keys of the tiles, updated as they are added and taken.
+  uint64_t hash;
+  // The letters plus one in ascending order, one byte each, so that
+  // the letter in the least significant byte is the largest. It is
+  // only defined while the rack has at most RACK_SIGNATURE_MAX_LETTERS
+  // and none of its counts are negative.
+  uint64_t signature;
 } Rack;
 
-void add_letter_to_rack(Rack *rack, uint8_t letter);
 Rack *create_rack(int array_size);
 Rack *copy_rack(Rack *rack);
 void copy_rack_into(Rack *dst, Rack *src);
@@ -25,7 +35,98 @@ void reset_rack(Rack *rack);
 int score_on_rack(LetterDistribution *letter_distribution, Rack *rack);
 void set_rack_to_string(Rack *rack, const char *rack_string,
                         LetterDistribution *letter_distribution);
-void take_letter_from_rack(Rack *rack, uint8_t letter);
 bool racks_are_equal(Rack *rack1, Rack *rack2);
+uint64_t get_rack_signature(Rack *rack);
+uint64_t compute_rack_signature(Rack *rack);
+void take_letter_not_on_rack(Rack *rack, uint8_t letter);
+void return_letter_not_on_rack(Rack *rack, uint8_t letter);
+
+// Returns a mask of the k least significant bytes, for k < 8.
+inline uint64_t get_signature_byte_mask(int k) {
+  return ((uint64_t)1 << (8 * k)) - 1;
+}
+
+// Inserts the letter after the bytes of the larger letters.
+// The signature must have fewer than RACK_SIGNATURE_MAX_LETTERS.
+inline uint64_t add_to_rack_signature(uint64_t signature,
+                                      int number_of_letters, uint8_t letter) {
+  uint64_t value = (uint64_t)letter + 1;
+  int k = 0;
+  while (k < number_of_letters && ((signature >> (8 * k)) & 0xFF) > value) {
+    k++;
+  }
+  uint64_t low_bytes = signature & get_signature_byte_mask(k);
+  return ((((signature >> (8 * k)) << 8) | value) << (8 * k)) | low_bytes;
+}
+
+inline uint64_t remove_from_rack_signature(uint64_t signature,
+                                           int number_of_letters,
+                                           uint8_t letter) {
+  uint64_t value = (uint64_t)letter + 1;
+  int k = 0;
+  while (k < number_of_letters && ((signature >> (8 * k)) & 0xFF) != value) {
+    k++;
+  }
+  if (k == number_of_letters) {
+    return signature;
+  }
+  uint64_t low_bytes = signature & get_signature_byte_mask(k);
+  return (((signature >> (8 * k)) >> 8) << (8 * k)) | low_bytes;
+}
+
+inline void take_letter_from_rack(Rack *rack, uint8_t letter) {
+  if (rack->array[letter] <= 0) {
+    take_letter_not_on_rack(rack, letter);
+    return;
+  }
+  if (rack->number_of_letters <= RACK_SIGNATURE_MAX_LETTERS) {
+    rack->signature = remove_from_rack_signature(
+        rack->signature, rack->number_of_letters, letter);
+  }
+  rack->array[letter]--;
+  rack->number_of_letters--;
+  rack->hash -= get_rack_letter_key(letter);
+  if (rack->number_of_letters == RACK_SIGNATURE_MAX_LETTERS) {
+    // The signature was not kept while the rack was too large.
+    rack->signature = compute_rack_signature(rack);
+  }
+  if (rack->number_of_letters == 0) {
+    rack->empty = 1;
+  }
+}
+
+inline void add_letter_to_rack(Rack *rack, uint8_t letter) {
+  if (rack->array[letter] < 0) {
+    return_letter_not_on_rack(rack, letter);
+    return;
+  }
+  if (rack->number_of_letters < RACK_SIGNATURE_MAX_LETTERS) {
+    rack->signature = add_to_rack_signature(
+        rack->signature, rack->number_of_letters, letter);
+  }
+  rack->array[letter]++;
+  rack->number_of_letters++;
+  rack->hash += get_rack_letter_key(letter);
+  if (rack->empty == 1) {
+    rack->empty = 0;
+  }
+}
+
+// Takes a tile for a search that returns it before anything reads the
+// rack hash or signature. Both depend only on the letters on the rack,
+// so they are valid again once every borrowed tile is returned.
+inline void borrow_letter_from_rack(Rack *rack, uint8_t letter) {
+  rack->array[letter]--;
+  rack->number_of_letters--;
+  if (rack->number_of_letters == 0) {
+    rack->empty = 1;
+  }
+}
+
+inline void return_letter_to_rack(Rack *rack, uint8_t letter) {
+  rack->array[letter]++;
+  rack->number_of_letters++;
+  rack->empty = 0;
+}
 
 #endif
\ No newline at end of file
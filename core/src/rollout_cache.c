@@ -0,0 +1,32 @@
+#include <stdint.h>
+
+#include "direct_mapped_cache.h"
+#include "move.h"
+#include "rollout_cache.h"
+
+RolloutCache *create_rollout_cache(int capacity) {
+  return create_direct_mapped_cache(capacity, sizeof(RolloutCacheEntry));
+}
+
+void destroy_rollout_cache(RolloutCache *rollout_cache) {
+  destroy_direct_mapped_cache(rollout_cache);
+}
+
+// Returns the entry for the position. If found is set to 0,
+// the entry holds another position and can be overwritten.
+RolloutCacheEntry *lookup_rollout_cache(RolloutCache *rollout_cache,
+                                        uint64_t position_key, int *found) {
+  // The key is already a hash, so its bits are uniform.
+  RolloutCacheEntry *entry =
+      get_direct_mapped_cache_entry(rollout_cache, position_key);
+  *found = entry->occupied && entry->position_key == position_key;
+  record_direct_mapped_cache_lookup(rollout_cache, *found);
+  return entry;
+}
+
+void set_rollout_cache_entry(RolloutCacheEntry *entry, uint64_t position_key,
+                             Move *top_move) {
+  entry->position_key = position_key;
+  entry->occupied = 1;
+  copy_move(top_move, &entry->top_move);
+}
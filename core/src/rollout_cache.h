@@ -0,0 +1,29 @@
+#ifndef ROLLOUT_CACHE_H
+#define ROLLOUT_CACHE_H
+
+#include <stdint.h>
+
+#include "direct_mapped_cache.h"
+#include "move.h"
+
+// The top equity move of a rollout position,
+// identified by the key of the position.
+typedef struct RolloutCacheEntry {
+  uint64_t position_key;
+  int occupied;
+  Move top_move;
+} RolloutCacheEntry;
+
+// Each sim worker has its own, since the table is not thread safe.
+// It hits when iterations draw into a position the worker has already
+// rolled out, which is most common in the shallow plies of the sim.
+typedef DirectMappedCache RolloutCache;
+
+RolloutCache *create_rollout_cache(int capacity);
+void destroy_rollout_cache(RolloutCache *rollout_cache);
+RolloutCacheEntry *lookup_rollout_cache(RolloutCache *rollout_cache,
+                                        uint64_t position_key, int *found);
+void set_rollout_cache_entry(RolloutCacheEntry *entry, uint64_t position_key,
+                             Move *top_move);
+
+#endif
@@ -9,13 +9,16 @@
 #include "gameplay.h"
 #include "go_params.h"
 #include "log.h"
+#include "movegen.h"
 #include "rack.h"
+#include "rollout_cache.h"
 #include "sim.h"
 #include "stats.h"
 #include "ucgi_formats.h"
 #include "ucgi_print.h"
 #include "util.h"
 #include "xoshiro.h"
+#include "zobrist.h"
 
 #define MAX_STOPPING_ITERATION_CT 4000
 #define PER_PLY_STOPPING_SCALING 1250
@@ -44,7 +47,7 @@ void create_simmed_plays(Simmer *simmer, Game *game,
        i++) {
     SimmedPlay *sp = malloc(sizeof(SimmedPlay));
     sp->move = create_move();
-    copy_move(game->gen->move_list->moves[i], sp->move);
+    copy_move(&game->gen->move_list->moves[i], sp->move);
 
     sp->score_stat = malloc(sizeof(Stat *) * simmer->max_plies);
     sp->bingo_stat = malloc(sizeof(Stat *) * simmer->max_plies);
@@ -120,6 +123,11 @@ SimmerWorker *create_simmer_worker(Simmer *simmer, Game *game,
 
   simmer_worker->rack_placeholder =
       create_rack(game->gen->letter_distribution->size);
+  simmer_worker->rollout_cache = create_rollout_cache(ROLLOUT_CACHE_SIZE);
+  simmer_worker->leave_cache_hits = 0;
+  simmer_worker->leave_cache_misses = 0;
+  simmer_worker->rollout_cache_hits = 0;
+  simmer_worker->rollout_cache_misses = 0;
   // Give each game bag the same seed, but then change these:
   seed_prng(new_game->gen->bag->prng, seed);
   // "jump" each bag's prng thread number of times.
@@ -133,6 +141,7 @@ SimmerWorker *create_simmer_worker(Simmer *simmer, Game *game,
 void destroy_simmer_worker(SimmerWorker *simmer_worker) {
   destroy_game(simmer_worker->game);
   destroy_rack(simmer_worker->rack_placeholder);
+  destroy_rollout_cache(simmer_worker->rollout_cache);
   free(simmer_worker);
 }
 
@@ -262,16 +271,81 @@ int handle_potential_stopping_condition(Simmer *simmer) {
   return 0;
 }
 
+// Identifies everything the top equity move depends on: the board,
+// the player on turn and their rack, the number of tiles in the bag
+// up to where the preendgame adjustments stop, and once the bag is
+// empty, the opponent's rack.
+uint64_t get_rollout_position_key(Game *game) {
+  int player_on_turn_index = game->player_on_turn_index;
+  int bag_tiles = game->gen->bag->last_tile_index + 1;
+  if (bag_tiles > PREENDGAME_ADJUSTMENT_VALUES_LENGTH) {
+    bag_tiles = PREENDGAME_ADJUSTMENT_VALUES_LENGTH;
+  }
+  uint64_t key = board_hash(game->gen->board);
+  key ^= zobrist_mix(ZOBRIST_GAME_SEED * (player_on_turn_index + 1) +
+                     game->players[player_on_turn_index]->rack->hash);
+  key ^= zobrist_mix(ZOBRIST_GAME_SEED * 3 + bag_tiles);
+  if (bag_tiles == 0) {
+    key ^= zobrist_mix(ZOBRIST_GAME_SEED * 4 +
+                       game->players[1 - player_on_turn_index]->rack->hash);
+  }
+  return key;
+}
+
+Move *get_rollout_top_equity_move(SimmerWorker *simmer_worker) {
+  Game *game = simmer_worker->game;
+  uint64_t position_key = get_rollout_position_key(game);
+  int found;
+  RolloutCacheEntry *entry = lookup_rollout_cache(
+      simmer_worker->rollout_cache, position_key, &found);
+  if (found) {
+    MoveList *move_list = game->gen->move_list;
+    copy_move(&entry->top_move, &move_list->moves[0]);
+    move_list->count = 1;
+    return &move_list->moves[0];
+  }
+  Move *top_move = get_top_equity_move(game);
+  set_rollout_cache_entry(entry, position_key, top_move);
+  return top_move;
+}
+
+// Adds the leave and rollout cache lookups the worker
+// made since the last call to the simmer.
+void add_cache_stats(SimmerWorker *simmer_worker) {
+  Simmer *simmer = simmer_worker->simmer;
+  uint64_t hits;
+  uint64_t misses;
+  get_leave_cache_stats(simmer_worker->game->gen, &hits, &misses);
+  atomic_fetch_add(&simmer->leave_cache_hits,
+                   hits - simmer_worker->leave_cache_hits);
+  atomic_fetch_add(&simmer->leave_cache_lookups,
+                   hits + misses - simmer_worker->leave_cache_hits -
+                       simmer_worker->leave_cache_misses);
+  simmer_worker->leave_cache_hits = hits;
+  simmer_worker->leave_cache_misses = misses;
+
+  hits = simmer_worker->rollout_cache->hits;
+  misses = simmer_worker->rollout_cache->misses;
+  atomic_fetch_add(&simmer->rollout_cache_hits,
+                   hits - simmer_worker->rollout_cache_hits);
+  atomic_fetch_add(&simmer->rollout_cache_lookups,
+                   hits + misses - simmer_worker->rollout_cache_hits -
+                       simmer_worker->rollout_cache_misses);
+  simmer_worker->rollout_cache_hits = hits;
+  simmer_worker->rollout_cache_misses = misses;
+}
+
 void sim_single_iteration(SimmerWorker *simmer_worker) {
   Game *game = simmer_worker->game;
   Rack *rack_placeholder = simmer_worker->rack_placeholder;
   Simmer *simmer = simmer_worker->simmer;
   int plies = simmer->max_plies;
 
-  // set random rack for opponent (throw in rack, shuffle, draw new tiles).
+  // need new draws for every iteration. The backups restore the stream
+  // for each simmed play, so that the plays all see the same draws.
+  reseed_prng(game->gen->bag, xoshiro_next(game->gen->bag->prng));
+  // set random rack for opponent (throw in rack, draw new tiles).
   set_random_rack(game, 1 - game->player_on_turn_index, simmer->known_opp_rack);
-  // need a new shuffle for every iteration:
-  shuffle(game->gen->bag);
 
   for (int i = 0; i < simmer->num_simmed_plays; i++) {
     if (simmer->simmed_plays[i]->ignore) {
@@ -292,7 +366,7 @@ void sim_single_iteration(SimmerWorker *simmer_worker) {
         break;
       }
 
-      Move *best_play = get_top_equity_move(game);
+      Move *best_play = get_rollout_top_equity_move(simmer_worker);
       copy_rack_into(rack_placeholder, game->players[onturn]->rack);
       play_move(game, best_play);
       atomic_fetch_add(&simmer->node_count, 1);
@@ -356,6 +430,7 @@ void *simmer_worker(void *uncasted_simmer_worker) {
       break;
     }
     sim_single_iteration(simmer_worker);
+    add_cache_stats(simmer_worker);
 
     if (thread_control->print_info_interval > 0 &&
         current_iteration_count > 0 &&
@@ -500,11 +575,25 @@ void simulate(ThreadControl *thread_control, Simmer *simmer, Game *game,
 
   int sorting_type = game->players[0]->strategy_params->move_sorting;
   game->players[0]->strategy_params->move_sorting = SORT_BY_EQUITY;
+  // Only the best num_plays plays are simmed or printed, so there
+  // is no need to record every play.
+  StrategyParams *on_turn_strategy_params =
+      game->players[game->player_on_turn_index]->strategy_params;
+  int play_recorder_type = on_turn_strategy_params->play_recorder_type;
+  on_turn_strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_TOP_K;
+  game->gen->max_recorded_moves = num_plays > 0 ? num_plays : 1;
+  // Generating plays can take a while in large positions,
+  // so split the anchors across the sim threads. The game keeps
+  // its own thread count for any later generation.
+  int movegen_threads = game->gen->number_of_threads;
+  set_movegen_threads(game->gen, threads);
   generate_moves(game->gen, game->players[game->player_on_turn_index],
                  game->players[1 - game->player_on_turn_index]->rack,
                  game->gen->bag->last_tile_index + 1 >= RACK_SIZE);
+  set_movegen_threads(game->gen, movegen_threads);
   int number_of_moves_generated = game->gen->move_list->count;
-  sort_moves(game->gen->move_list);
+  sort_top_moves(game->gen->move_list, game->gen->max_recorded_moves);
+  on_turn_strategy_params->play_recorder_type = play_recorder_type;
   game->players[0]->strategy_params->move_sorting = sorting_type;
 
   if (static_search_only) {
@@ -535,6 +624,10 @@ void simulate(ThreadControl *thread_control, Simmer *simmer, Game *game,
   simmer->initial_spread = game->players[game->player_on_turn_index]->score -
                            game->players[1 - game->player_on_turn_index]->score;
   atomic_init(&simmer->node_count, 0);
+  atomic_init(&simmer->rollout_cache_hits, 0);
+  atomic_init(&simmer->rollout_cache_lookups, 0);
+  atomic_init(&simmer->leave_cache_hits, 0);
+  atomic_init(&simmer->leave_cache_lookups, 0);
   create_simmed_plays(simmer, game, number_of_moves_generated);
 
   if (simmer->num_simmed_plays > 1 && number_of_moves_generated > 1) {
@@ -7,6 +7,7 @@
 #include "game.h"
 #include "move.h"
 #include "rack.h"
+#include "rollout_cache.h"
 #include "stats.h"
 #include "thread_control.h"
 #include "winpct.h"
@@ -55,6 +56,10 @@ typedef struct Simmer {
 
   int *play_similarity_cache;
   atomic_int node_count;
+  atomic_int rollout_cache_hits;
+  atomic_int rollout_cache_lookups;
+  atomic_int leave_cache_hits;
+  atomic_int leave_cache_lookups;
   ThreadControl *thread_control;
 } Simmer;
 
@@ -62,6 +67,15 @@ typedef struct SimmerWorker {
   int thread_index;
   Game *game;
   Rack *rack_placeholder;
+  // Rollouts often reach the same position again, for example
+  // when the opponent draws the same rack after the same play.
+  RolloutCache *rollout_cache;
+  // The lookups of the worker's leave and rollout caches that were
+  // already added to the simmer, which counts them for all workers.
+  uint64_t leave_cache_hits;
+  uint64_t leave_cache_misses;
+  uint64_t rollout_cache_hits;
+  uint64_t rollout_cache_misses;
   Simmer *simmer;
 } SimmerWorker;
 
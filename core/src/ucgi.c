@@ -15,11 +15,75 @@
 #include "ucgi_print.h"
 #include "util.h"
 
-#define CMD_MAX 256
+#define CMD_MAX (MAX_CGP_LENGTH)
 
-void ucgi_scan_loop() {
-  UCGICommandVars *ucgi_command_vars = create_ucgi_command_vars(stdout);
+#ifdef SUPER_CROSSWORD_GAME_VARIANT
+// These are the same functions compiled with
+// BOARD_DIM == SUPER_CROSSWORD_GAME_BOARD_DIM. The Makefile links them
+// into this binary with their symbols prefixed by "super_". Every global
+// of that copy is separate from the one here, so its log level and file
+// cache are not shared with this copy, and it loads its own lexicon.
+UCGICommandVars *super_create_ucgi_command_vars(FILE *outfile);
+void super_destroy_ucgi_command_vars(UCGICommandVars *ucgi_command_vars);
+int super_process_ucgi_command_async(char *cmd,
+                                     UCGICommandVars *ucgi_command_vars);
+#endif
+
+UCGIVariantVars *create_ucgi_variant_vars(FILE *outfile) {
+  UCGIVariantVars *ucgi_variant_vars = malloc(sizeof(UCGIVariantVars));
+  ucgi_variant_vars->ucgi_command_vars = create_ucgi_command_vars(outfile);
+  ucgi_variant_vars->super_ucgi_command_vars = NULL;
+  ucgi_variant_vars->use_super_variant = 0;
+  ucgi_variant_vars->outfile = outfile;
+  return ucgi_variant_vars;
+}
+
+void destroy_ucgi_variant_vars(UCGIVariantVars *ucgi_variant_vars) {
+  destroy_ucgi_command_vars(ucgi_variant_vars->ucgi_command_vars);
+#ifdef SUPER_CROSSWORD_GAME_VARIANT
+  if (ucgi_variant_vars->super_ucgi_command_vars != NULL) {
+    super_destroy_ucgi_command_vars(ucgi_variant_vars->super_ucgi_command_vars);
+  }
+#endif
+  free(ucgi_variant_vars);
+}
 
+int process_ucgi_variant_command_async(char *cmd,
+                                       UCGIVariantVars *ucgi_variant_vars) {
+#ifdef SUPER_CROSSWORD_GAME_VARIANT
+  // Each position is handled by the variant compiled for its board
+  // dimension. Commands that follow go to the variant of the last
+  // loaded position.
+  if (prefix("position cgp ", cmd)) {
+    ucgi_variant_vars->use_super_variant =
+        get_cgp_board_dim(cmd + strlen("position cgp ")) ==
+        SUPER_CROSSWORD_GAME_BOARD_DIM;
+    if (ucgi_variant_vars->use_super_variant &&
+        ucgi_variant_vars->super_ucgi_command_vars == NULL) {
+      ucgi_variant_vars->super_ucgi_command_vars =
+          super_create_ucgi_command_vars(ucgi_variant_vars->outfile);
+    }
+  }
+  // A search keeps running in its variant after a position for the
+  // other board dimension is loaded, so stop and quit go to both.
+  if (ucgi_variant_vars->super_ucgi_command_vars != NULL &&
+      (strcmp(cmd, "stop") == 0 || strcmp(cmd, "quit") == 0)) {
+    int super_status = super_process_ucgi_command_async(
+        cmd, ucgi_variant_vars->super_ucgi_command_vars);
+    int status =
+        process_ucgi_command_async(cmd, ucgi_variant_vars->ucgi_command_vars);
+    return ucgi_variant_vars->use_super_variant ? super_status : status;
+  }
+  if (ucgi_variant_vars->use_super_variant) {
+    return super_process_ucgi_command_async(
+        cmd, ucgi_variant_vars->super_ucgi_command_vars);
+  }
+#endif
+  return process_ucgi_command_async(cmd, ucgi_variant_vars->ucgi_command_vars);
+}
+
+void ucgi_scan_loop() {
+  UCGIVariantVars *ucgi_variant_vars = create_ucgi_variant_vars(stdout);
   while (1) {
     char cmd[CMD_MAX];
     if (fgets(cmd, CMD_MAX, stdin) == NULL) {
@@ -27,13 +91,10 @@ void ucgi_scan_loop() {
     }
     // replace newline with 0 for ease in comparison
     cmd[strcspn(cmd, "\n")] = 0;
-
-    int should_end = process_ucgi_command_async(cmd, ucgi_command_vars);
+    int should_end = process_ucgi_variant_command_async(cmd, ucgi_variant_vars);
     if (should_end) {
       break;
     }
   }
-  if (ucgi_command_vars != NULL) {
-    destroy_ucgi_command_vars(ucgi_command_vars);
-  }
+  destroy_ucgi_variant_vars(ucgi_variant_vars);
 }
@@ -1,5 +1,23 @@
 #ifndef UCGI_H
 #define UCGI_H
 
+#include <stdio.h>
+
+#include "ucgi_command.h"
+
+// The command state for each board dimension served by this binary.
+typedef struct UCGIVariantVars {
+  UCGICommandVars *ucgi_command_vars;
+  // Created for the first super crossword game position. It has its own
+  // config, so the lexicon and leaves are loaded again for this board.
+  UCGICommandVars *super_ucgi_command_vars;
+  int use_super_variant;
+  FILE *outfile;
+} UCGIVariantVars;
+
+UCGIVariantVars *create_ucgi_variant_vars(FILE *outfile);
+void destroy_ucgi_variant_vars(UCGIVariantVars *ucgi_variant_vars);
+int process_ucgi_variant_command_async(char *cmd,
+                                       UCGIVariantVars *ucgi_variant_vars);
 void ucgi_scan_loop();
 #endif
\ No newline at end of file
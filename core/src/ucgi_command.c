@@ -300,6 +300,10 @@ int process_ucgi_command_async(char *cmd, UCGICommandVars *ucgi_command_vars) {
   // other commands
   if (prefix("position cgp ", cmd)) {
     char *cgpstr = cmd + strlen("position cgp ");
+    if (get_cgp_board_dim(cgpstr) != BOARD_DIM) {
+      log_warn("Board dimension is not supported by this build.");
+      return UCGI_COMMAND_STATUS_UNSUPPORTED_BOARD_DIM;
+    }
     char lexicon[16] = "";
     char ldname[16] = "";
     lexicon_ld_from_cgp(cgpstr, lexicon, ldname);
@@ -13,6 +13,7 @@
 #define UCGI_COMMAND_STATUS_NOT_STOPPED 2
 #define UCGI_COMMAND_STATUS_LEXICON_LD_FAILURE 3
 #define UCGI_COMMAND_STATUS_QUIT 4
+#define UCGI_COMMAND_STATUS_UNSUPPORTED_BOARD_DIM 5
 
 typedef struct UCGICommandVars {
   Game *loaded_game;
@@ -170,6 +170,17 @@ void print_ucgi_inference(Inference *inference, ThreadControl *thread_control) {
   }
   print_to_file(thread_control, starting_records_string_pointer);
   free(starting_records_string_pointer);
+
+  uint64_t leave_cache_lookups =
+      inference->leave_cache_hits + inference->leave_cache_misses;
+  if (leave_cache_lookups > 0) {
+    char leave_cache_string[100];
+    sprintf(leave_cache_string, "info leavecache %llu %llu %f\n",
+            (long long unsigned int)inference->leave_cache_hits,
+            (long long unsigned int)inference->leave_cache_misses,
+            (double)inference->leave_cache_hits / leave_cache_lookups);
+    print_to_file(thread_control, leave_cache_string);
+  }
 }
 
 // Sim
@@ -179,17 +190,17 @@ char *ucgi_static_moves(Game *game, int nmoves) {
   char *moves_string = (char *)malloc(moves_size);
   char *starting_moves_string_pointer = moves_string;
   moves_string[0] = '\0';
-  for (int i = 0; i < nmoves; i++) {
+  for (int i = 0; i < nmoves && i < game->gen->move_list->count; i++) {
     char move[30];
-    store_move_ucgi(game->gen->move_list->moves[i], game->gen->board, move,
+    store_move_ucgi(&game->gen->move_list->moves[i], game->gen->board, move,
                     game->gen->letter_distribution);
     moves_string +=
         sprintf(moves_string, "info currmove %s sc %d eq %.3f it 0\n", move,
-                game->gen->move_list->moves[i]->score,
-                game->gen->move_list->moves[i]->equity);
+                game->gen->move_list->moves[i].score,
+                game->gen->move_list->moves[i].equity);
   }
   char move[30];
-  store_move_ucgi(game->gen->move_list->moves[0], game->gen->board, move,
+  store_move_ucgi(&game->gen->move_list->moves[0], game->gen->board, move,
                   game->gen->letter_distribution);
   sprintf(moves_string, "bestmove %s\n", move);
   return starting_moves_string_pointer;
@@ -271,7 +282,22 @@ char *ucgi_sim_stats(Simmer *simmer, Game *game, int best_known_play) {
   } else {
     stats_string += sprintf(stats_string, "bestsofar %s\n", move);
   }
-  stats_string += sprintf(stats_string, "info nps %f\n", nps);
+  int rollout_cache_lookups = atomic_load(&simmer->rollout_cache_lookups);
+  double rollout_cache_hit_rate = 0;
+  if (rollout_cache_lookups > 0) {
+    rollout_cache_hit_rate =
+        (double)atomic_load(&simmer->rollout_cache_hits) /
+        rollout_cache_lookups;
+  }
+  int leave_cache_lookups = atomic_load(&simmer->leave_cache_lookups);
+  double leave_cache_hit_rate = 0;
+  if (leave_cache_lookups > 0) {
+    leave_cache_hit_rate = (double)atomic_load(&simmer->leave_cache_hits) /
+                           leave_cache_lookups;
+  }
+  stats_string +=
+      sprintf(stats_string, "info nps %f rolloutcache %f leavecache %f\n", nps,
+              rollout_cache_hit_rate, leave_cache_hit_rate);
   return starting_stats_string_pointer;
 }
 
@@ -295,4 +321,14 @@ void print_ucgi_autoplay_results(AutoplayResults *autoplay_results,
           get_mean(autoplay_results->p2_score),
           get_stdev(autoplay_results->p2_score));
   print_to_file(thread_control, results_string);
+
+  uint64_t leave_cache_lookups =
+      autoplay_results->leave_cache_hits + autoplay_results->leave_cache_misses;
+  if (leave_cache_lookups > 0) {
+    sprintf(results_string, "info leavecache %llu %llu %f\n",
+            (long long unsigned int)autoplay_results->leave_cache_hits,
+            (long long unsigned int)autoplay_results->leave_cache_misses,
+            (double)autoplay_results->leave_cache_hits / leave_cache_lookups);
+    print_to_file(thread_control, results_string);
+  }
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "undo_log.h"
+
+UndoLog *create_undo_log(int capacity) {
+  UndoLog *undo_log = malloc(sizeof(UndoLog));
+  undo_log->entries = malloc(sizeof(UndoEntry) * capacity);
+  undo_log->number_of_entries = 0;
+  undo_log->capacity = capacity;
+  return undo_log;
+}
+
+void destroy_undo_log(UndoLog *undo_log) {
+  free(undo_log->entries);
+  free(undo_log);
+}
+
+void push_undo_entry(UndoLog *undo_log, undo_entry_t type, uint32_t index,
+                     uint64_t old_value) {
+  if (undo_log->number_of_entries == undo_log->capacity) {
+    // Deep searches can outgrow the initial capacity.
+    undo_log->capacity *= 2;
+    undo_log->entries =
+        realloc(undo_log->entries, sizeof(UndoEntry) * undo_log->capacity);
+    if (!undo_log->entries) {
+      printf("error: could not grow undo log to %d entries\n",
+             undo_log->capacity);
+      abort();
+    }
+  }
+  UndoEntry *entry = &undo_log->entries[undo_log->number_of_entries++];
+  entry->old_value = old_value;
+  entry->index = index;
+  entry->type = type;
+}
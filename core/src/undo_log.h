@@ -0,0 +1,34 @@
+#ifndef UNDO_LOG_H
+#define UNDO_LOG_H
+
+#include <stdint.h>
+
+typedef enum {
+  UNDO_BOARD_LETTER,
+  UNDO_BOARD_CROSS_SET,
+  UNDO_BOARD_CROSS_SCORE,
+  UNDO_BAG_TILE,
+} undo_entry_t;
+
+// The value held before a single write, with the untransposed index
+// of the square, cross set or bag tile that was written.
+typedef struct UndoEntry {
+  uint64_t old_value;
+  uint32_t index;
+  uint8_t type;
+} UndoEntry;
+
+// A journal of writes that can be undone in reverse order. Writers
+// append to it while it is attached, so it only holds what changed.
+typedef struct UndoLog {
+  UndoEntry *entries;
+  int number_of_entries;
+  int capacity;
+} UndoLog;
+
+UndoLog *create_undo_log(int capacity);
+void destroy_undo_log(UndoLog *undo_log);
+void push_undo_entry(UndoLog *undo_log, undo_entry_t type, uint32_t index,
+                     uint64_t old_value);
+
+#endif
@@ -154,7 +154,8 @@ char *static_evaluation(char *cgpstr, int num_plays) {
   if (number_of_moves_generated < num_plays) {
     num_plays = number_of_moves_generated;
   }
-  sort_moves(game->gen->move_list);
+  // Only the printed moves and the best move need to be ordered.
+  sort_top_moves(game->gen->move_list, num_plays > 0 ? num_plays : 1);
   game->players[0]->strategy_params->move_sorting = sorting_type;
   // This pointer needs to be freed by the caller:
   char *val = ucgi_static_moves(game, num_plays);
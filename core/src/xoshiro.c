@@ -45,6 +45,22 @@ uint64_t xoshiro_next(XoshiroPRNG *prng) {
   return result;
 }
 
+// Returns a uniform integer in [0, bound) with Lemire's multiply and
+// reject method, which avoids both the bias of a modulo and, almost
+// always, the division.
+uint32_t xoshiro_next_bounded(XoshiroPRNG *prng, uint32_t bound) {
+  uint64_t product = (xoshiro_next(prng) >> 32) * bound;
+  uint32_t low = (uint32_t)product;
+  if (low < bound) {
+    uint32_t threshold = -bound % bound;
+    while (low < threshold) {
+      product = (xoshiro_next(prng) >> 32) * bound;
+      low = (uint32_t)product;
+    }
+  }
+  return product >> 32;
+}
+
 /* This is the jump function for the generator. It is equivalent
    to 2^128 calls to next(); it can be used to generate 2^128
    non-overlapping subsequences for parallel computations. */
@@ -125,19 +141,20 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
    It is a very fast generator passing BigCrush, and it can be useful if
    for some reason you absolutely want 64 bits of state. */
 
-static uint64_t xxsplit; /* The state can be seeded with any value. */
+/* The state can be seeded with any value. It is local to each
+   seeding so that generators can be reseeded from several threads. */
 
-uint64_t splitmix_next() {
-  uint64_t z = (xxsplit += 0x9e3779b97f4a7c15);
+uint64_t splitmix_next(uint64_t *xxsplit) {
+  uint64_t z = (*xxsplit += 0x9e3779b97f4a7c15);
   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
   z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
   return z ^ (z >> 31);
 }
 
 void seed_prng(XoshiroPRNG *prng, uint64_t seed) {
-  xxsplit = seed;
+  uint64_t xxsplit = seed;
   for (int i = 0; i < 4; i++) {
-    prng->s[i] = splitmix_next();
+    prng->s[i] = splitmix_next(&xxsplit);
   }
 }
 
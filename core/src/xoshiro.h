@@ -14,6 +14,7 @@ void copy_prng_into(XoshiroPRNG *dst, XoshiroPRNG *src);
 void seed_prng(XoshiroPRNG *x, uint64_t seed);
 void xoshiro_jump(XoshiroPRNG *x);
 uint64_t xoshiro_next(XoshiroPRNG *x);
+uint32_t xoshiro_next_bounded(XoshiroPRNG *x, uint32_t bound);
 void destroy_prng(XoshiroPRNG *x);
 
 #endif
\ No newline at end of file
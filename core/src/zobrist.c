@@ -0,0 +1,28 @@
+#include <stdint.h>
+
+#include "constants.h"
+#include "zobrist.h"
+
+const uint64_t rack_letter_keys[MAX_ALPHABET_SIZE] = {
+    0x0ed0f969dcaea4d2, 0x4fa47f4acb65dc03, 0xa6331ff9553f0d88,
+    0x6226f15da315a487, 0x449535f9b5e6b1e4, 0x46292e33698d788d,
+    0xc32e3a552def3160, 0x29505a3c6e8c3f2e, 0xa11177d01900344a,
+    0x03342a9f7a294206, 0xd8f171003883550c, 0x6e1aa66d9f8711a8,
+    0xe482b2b593d258bc, 0x57b71f2ac1fceebb, 0xa107c36894247870,
+    0x4744c7950b6ea507, 0xd1051396e47b39cd, 0x9861a22155f937f5,
+    0xe032d92ef0230438, 0x95cd086c5a50e2a5, 0xb8401c863a5c2a86,
+    0x01f83180bb167779, 0x9343cc5bd0d501b3, 0x065c480b0220da6f,
+    0x271bdb7ebbdebb87, 0x6213729dc00c161c, 0xf90c997a89c78adb,
+    0x0f5d841d3de95786, 0x160855e34ec358ed, 0xd90dfcd24ff7f962,
+    0xddee45733d443dab, 0x0694b284295a1749, 0xaf3c18e7ab31f77f,
+    0x70ed9e889d63b0ee, 0x40cb7b35abc8095e, 0xc81f275c902f8a3a,
+    0x67f20ed0337dbdcb, 0x72bfe5d2823979aa, 0x410bd60e66296720,
+    0x187f7bb3e9217795, 0x9396ab23a680303c, 0xa93c17e183f4419e,
+    0x05bf88025cb6bf2f, 0xd3aef6881f06ae45, 0xd610d6539c3885c1,
+    0x1338c8ad7714ec69, 0xe231be3bebb93348, 0x7a694ab76aa393fc,
+    0x893bc414d93999b4, 0x95fc15e75133ce9d,
+};
+
+extern inline uint64_t zobrist_mix(uint64_t x);
+extern inline uint64_t get_square_key(int index, uint8_t letter);
+extern inline uint64_t get_rack_letter_key(uint8_t letter);
@@ -0,0 +1,35 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <stdint.h>
+
+#include "constants.h"
+
+// The splitmix64 finalizer. It maps nearby inputs to unrelated
+// outputs, so square keys are computed on demand instead of stored.
+inline uint64_t zobrist_mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+// The key of a letter on an untransposed square. Empty squares
+// have no key, so the hash of an empty board is 0.
+inline uint64_t get_square_key(int index, uint8_t letter) {
+  if (letter == ALPHABET_EMPTY_SQUARE_MARKER) {
+    return 0;
+  }
+  return zobrist_mix(ZOBRIST_SQUARE_SEED + index * 256 + letter);
+}
+
+// zobrist_mix(ZOBRIST_RACK_SEED + letter) for each letter, stored
+// since a rack key is needed every time a tile is added or taken.
+extern const uint64_t rack_letter_keys[MAX_ALPHABET_SIZE];
+
+// Rack hashes are the sum of the keys of their tiles, so a tile
+// can be added or taken whatever the count of its letter.
+inline uint64_t get_rack_letter_key(uint8_t letter) {
+  return rack_letter_keys[letter];
+}
+
+#endif
@@ -188,7 +188,7 @@ void play_game_test(ThreadControl *thread_control, Game *game,
                    game->gen->bag->last_tile_index + 1 >= RACK_SIZE);
 
     Move *move_to_play = create_move();
-    copy_move(game->gen->move_list->moves[0], move_to_play);
+    copy_move(&game->gen->move_list->moves[0], move_to_play);
     if (test_inference && (move_to_play->move_type == MOVE_TYPE_EXCHANGE ||
                            move_to_play->move_type == MOVE_TYPE_PLAY)) {
       reset_rack(tiles_played);
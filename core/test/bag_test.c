@@ -5,6 +5,7 @@
 #include "../src/config.h"
 #include "../src/gameplay.h"
 #include "../src/letter_distribution.h"
+#include "../src/undo_log.h"
 
 #include "bag_print.h"
 #include "superconfig.h"
@@ -27,6 +28,71 @@ void test_add_letter(Config *config, Bag *bag, char *r,
   assert(!strcmp(bag_string, expected_bag_string));
 }
 
+int count_letter_in_bag(Bag *bag, uint8_t letter) {
+  int number_of_letters = 0;
+  for (int k = 0; k <= bag->last_tile_index; k++) {
+    if (bag->tiles[k] == letter) {
+      number_of_letters++;
+    }
+  }
+  return number_of_letters;
+}
+
+void test_draw_letter(Config *config) {
+  LetterDistribution *letter_distribution = config->letter_distribution;
+  Bag *bag = create_bag(letter_distribution);
+  Rack *rack = create_rack(letter_distribution->size);
+  UndoLog *undo_log = create_undo_log(UNDO_LOG_INITIAL_CAPACITY);
+
+  // Scramble the tile indexes before the letters are drawn by name.
+  bag->undo_log = undo_log;
+  draw_at_most_to_rack(bag, rack, 30);
+  for (int i = 0; i < (int)letter_distribution->size; i++) {
+    for (int k = 0; k < rack->array[i]; k++) {
+      add_letter(bag, i);
+    }
+  }
+  reset_rack(rack);
+  draw_at_most_to_rack(bag, rack, 3);
+  int last_tile_index = bag->last_tile_index;
+  uint8_t tiles[BAG_SIZE];
+  memcpy(tiles, bag->tiles, sizeof(tiles));
+  int mark = undo_log->number_of_entries;
+
+  for (int i = (int)letter_distribution->size - 1; i >= 0; i--) {
+    int number_of_letters = count_letter_in_bag(bag, i);
+    while (number_of_letters > 0) {
+      draw_letter(bag, i);
+      number_of_letters--;
+      assert(count_letter_in_bag(bag, i) == number_of_letters);
+    }
+    // Drawing a letter that is not in the bag does nothing.
+    draw_letter(bag, i);
+    assert(count_letter_in_bag(bag, i) == 0);
+  }
+  assert(bag->last_tile_index == -1);
+
+  // The journal restores the tiles along with their letter lists.
+  for (int i = undo_log->number_of_entries - 1; i >= mark; i--) {
+    undo_bag_change(bag, &undo_log->entries[i]);
+  }
+  bag->last_tile_index = last_tile_index;
+  bag->undo_log = NULL;
+  assert(!memcmp(bag->tiles, tiles, last_tile_index + 1));
+  for (int i = 0; i < (int)letter_distribution->size; i++) {
+    int number_of_letters = count_letter_in_bag(bag, i);
+    for (int k = 0; k < number_of_letters; k++) {
+      draw_letter(bag, i);
+    }
+    assert(count_letter_in_bag(bag, i) == 0);
+  }
+  assert(bag->last_tile_index == -1);
+
+  destroy_undo_log(undo_log);
+  destroy_rack(rack);
+  destroy_bag(bag);
+}
+
 void test_bag(SuperConfig *superconfig) {
   Config *config = get_nwl_config(superconfig);
   Bag *bag = create_bag(config->letter_distribution);
@@ -46,6 +112,8 @@ void test_bag(SuperConfig *superconfig) {
   }
 
   int number_of_remaining_tiles = bag->last_tile_index + 1;
+  uint32_t drawn[MAX_ALPHABET_SIZE];
+  memset(drawn, 0, sizeof(drawn));
 
   // Check drawing from the bag
   while (bag->last_tile_index + 1 > RACK_SIZE) {
@@ -54,6 +122,9 @@ void test_bag(SuperConfig *superconfig) {
     assert(bag->last_tile_index + 1 == number_of_remaining_tiles);
     assert(!rack->empty);
     assert(rack->number_of_letters == RACK_SIZE);
+    for (int i = 0; i < rack->array_size; i++) {
+      drawn[i] += rack->array[i];
+    }
     reset_rack(rack);
   }
 
@@ -61,6 +132,13 @@ void test_bag(SuperConfig *superconfig) {
   assert(bag->last_tile_index == -1);
   assert(!rack->empty);
   assert(rack->number_of_letters == number_of_remaining_tiles);
+  for (int i = 0; i < rack->array_size; i++) {
+    drawn[i] += rack->array[i];
+  }
+  // Every tile is drawn exactly once.
+  for (uint32_t i = 0; i < (config->letter_distribution->size); i++) {
+    assert(drawn[i] == config->letter_distribution->distribution[i]);
+  }
   reset_rack(rack);
 
   // Check adding letters to the bag
@@ -75,4 +153,6 @@ void test_bag(SuperConfig *superconfig) {
 
   destroy_bag(bag);
   destroy_rack(rack);
+
+  test_draw_letter(config);
 }
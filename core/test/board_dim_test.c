@@ -0,0 +1,207 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/config.h"
+#include "../src/constants.h"
+#include "../src/game.h"
+#include "../src/movegen.h"
+#include "../src/thread_control.h"
+#include "../src/ucgi.h"
+#include "../src/ucgi_command.h"
+
+#include "board_dim_test.h"
+#include "test_constants.h"
+
+// This file is also compiled with the super crossword game BOARD_DIM and
+// linked into the test binary with every symbol prefixed by "super_", like
+// the engine copy it runs against. It only calls engine functions so that
+// each copy uses the structs of its own board dimension.
+
+#define BOARD_DIM_TEST_RACK "IILLNOZ"
+#define BOARD_DIM_SEARCH_SECONDS 10
+
+Config *create_board_dim_test_config() {
+  return create_config("./data/letterdistributions/english.csv", "",
+                       "./data/lexica/CSW21.kwg", "./data/lexica/CSW21.klv2",
+                       SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL, "", "", -1, -1,
+                       0, 0, 0, 0, NULL, 0, 0, 0, 0, 1, "", MOVE_LIST_CAPACITY,
+                       KWG_LOAD_MODE_MMAP, 0, LEAVE_CACHE_SIZE, 0);
+}
+
+// Writes the cgp of a board with BOARD_DIM rows that are all empty
+// except for the last one.
+void write_board_dim_cgp(char *cgp, const char *last_row, const char *rack) {
+  cgp[0] = '\0';
+  for (int row = 0; row < BOARD_DIM - 1; row++) {
+    sprintf(cgp + strlen(cgp), "%d/", BOARD_DIM);
+  }
+  sprintf(cgp + strlen(cgp), "%s %s/ 0/0 0 lex CSW21;", last_row, rack);
+}
+
+void generate_board_dim_moves(Game *game, const char *cgp) {
+  reset_game(game);
+  load_cgp(game, cgp);
+  reset_move_list(game->gen->move_list);
+  generate_moves(game->gen, game->players[game->player_on_turn_index],
+                 game->players[1 - game->player_on_turn_index]->rack, 0);
+}
+
+int test_board_dim_movegen() {
+  Config *config = create_board_dim_test_config();
+  Game *game = create_game(config);
+  MoveList *move_list = game->gen->move_list;
+  char cgp[MAX_CGP_LENGTH];
+  char last_row[20];
+
+  // Every opening play is horizontal and covers the center square.
+  sprintf(last_row, "%d", BOARD_DIM);
+  write_board_dim_cgp(cgp, last_row, BOARD_DIM_TEST_RACK);
+  generate_board_dim_moves(game, cgp);
+  int center = BOARD_DIM / 2;
+  int number_of_opening_plays = 0;
+  for (int i = 0; i < move_list->count; i++) {
+    Move *move = &move_list->moves[i];
+    if (move->move_type != MOVE_TYPE_PLAY) {
+      continue;
+    }
+    assert(!move->vertical);
+    assert(move->row_start == center);
+    assert(move->col_start <= center);
+    assert(move->col_start + move->tiles_length > center);
+    number_of_opening_plays++;
+  }
+  assert(number_of_opening_plays > 0);
+
+  // With a word in the bottom right corner, every play ends next to it,
+  // on squares that only exist on a board of this size.
+  sprintf(last_row, "%dCARE", BOARD_DIM - 4);
+  write_board_dim_cgp(cgp, last_row, "AEINRST");
+  generate_board_dim_moves(game, cgp);
+  int number_of_plays = 0;
+  for (int i = 0; i < move_list->count; i++) {
+    Move *move = &move_list->moves[i];
+    if (move->move_type != MOVE_TYPE_PLAY) {
+      continue;
+    }
+    int last_row_index = move->row_start;
+    int last_col_index = move->col_start;
+    if (move->vertical) {
+      last_row_index += move->tiles_length - 1;
+    } else {
+      last_col_index += move->tiles_length - 1;
+    }
+    assert(last_row_index >= BOARD_DIM - 2 && last_row_index < BOARD_DIM);
+    assert(last_col_index >= BOARD_DIM - 5 && last_col_index < BOARD_DIM);
+    number_of_plays++;
+  }
+  assert(number_of_plays > 0);
+
+  destroy_game(game);
+  destroy_config(config);
+  return number_of_opening_plays;
+}
+
+// Waits for the search started by the last go command to finish.
+void wait_for_board_dim_search(UCGICommandVars *ucgi_command_vars) {
+  for (int i = 0; get_mode(ucgi_command_vars->thread_control) != MODE_STOPPED;
+       i++) {
+    if (i >= BOARD_DIM_SEARCH_SECONDS) {
+      fprintf(stderr, "Test aborted after searching for %d seconds",
+              BOARD_DIM_SEARCH_SECONDS);
+      abort();
+    }
+    sleep(1);
+  }
+}
+
+#ifdef SUPER_CROSSWORD_GAME_VARIANT
+int super_test_board_dim_movegen();
+void super_wait_for_board_dim_search(UCGICommandVars *ucgi_command_vars);
+
+// Loads the position and statically evaluates it, returning the output.
+char *ucgi_board_dim_static_search(UCGIVariantVars *ucgi_variant_vars,
+                                   const char *cgp, char **output_buffer,
+                                   size_t *len) {
+  char cmd[MAX_CGP_LENGTH];
+  fflush(ucgi_variant_vars->outfile);
+  size_t prev_len = *len;
+  sprintf(cmd, "position cgp %s", cgp);
+  assert(process_ucgi_variant_command_async(cmd, ucgi_variant_vars) ==
+         UCGI_COMMAND_STATUS_SUCCESS);
+  sprintf(cmd, "go sim depth 2 threads 2 plays 5 static");
+  assert(process_ucgi_variant_command_async(cmd, ucgi_variant_vars) ==
+         UCGI_COMMAND_STATUS_SUCCESS);
+  if (ucgi_variant_vars->use_super_variant) {
+    super_wait_for_board_dim_search(ucgi_variant_vars->super_ucgi_command_vars);
+  } else {
+    wait_for_board_dim_search(ucgi_variant_vars->ucgi_command_vars);
+  }
+  fflush(ucgi_variant_vars->outfile);
+  return *output_buffer + prev_len;
+}
+
+void test_ucgi_board_dim_dispatch() {
+  char *output_buffer;
+  size_t len;
+  FILE *outfile = open_memstream(&output_buffer, &len);
+  UCGIVariantVars *ucgi_variant_vars = create_ucgi_variant_vars(outfile);
+  char super_cgp[MAX_CGP_LENGTH];
+  char last_row[20];
+  sprintf(last_row, "%d", SUPER_CROSSWORD_GAME_BOARD_DIM);
+  super_cgp[0] = '\0';
+  for (int row = 0; row < SUPER_CROSSWORD_GAME_BOARD_DIM - 1; row++) {
+    sprintf(super_cgp + strlen(super_cgp), "%d/",
+            SUPER_CROSSWORD_GAME_BOARD_DIM);
+  }
+  sprintf(super_cgp + strlen(super_cgp), "%s %s/ 0/0 0 lex CSW21;", last_row,
+          BOARD_DIM_TEST_RACK);
+
+  // A 21x21 position is served by the super variant, which is
+  // only created once such a position is loaded.
+  char *output = ucgi_board_dim_static_search(ucgi_variant_vars, super_cgp,
+                                              &output_buffer, &len);
+  assert(ucgi_variant_vars->use_super_variant);
+  assert(ucgi_variant_vars->super_ucgi_command_vars);
+  assert(strstr(output, "bestmove 11"));
+  assert(strstr(output, ".ZILLION"));
+
+  // A search started on the 21x21 board is still stopped
+  // after a 15x15 position is loaded.
+  char cmd[MAX_CGP_LENGTH];
+  sprintf(cmd, "go sim depth 2 threads 2 plays 5 i 100000000");
+  assert(process_ucgi_variant_command_async(cmd, ucgi_variant_vars) ==
+         UCGI_COMMAND_STATUS_SUCCESS);
+  sprintf(cmd, "position cgp %s", ZILLION_OPENING_CGP);
+  assert(process_ucgi_variant_command_async(cmd, ucgi_variant_vars) ==
+         UCGI_COMMAND_STATUS_SUCCESS);
+  assert(!ucgi_variant_vars->use_super_variant);
+  sprintf(cmd, "stop");
+  assert(process_ucgi_variant_command_async(cmd, ucgi_variant_vars) ==
+         UCGI_COMMAND_STATUS_SUCCESS);
+  super_wait_for_board_dim_search(ucgi_variant_vars->super_ucgi_command_vars);
+
+  // The 15x15 position goes back to the default variant.
+  output = ucgi_board_dim_static_search(ucgi_variant_vars, ZILLION_OPENING_CGP,
+                                        &output_buffer, &len);
+  assert(!ucgi_variant_vars->use_super_variant);
+  assert(strstr(output, "bestmove 8d.ZILLION"));
+
+  destroy_ucgi_variant_vars(ucgi_variant_vars);
+  fclose(outfile);
+  free(output_buffer);
+}
+#endif
+
+void test_board_dim() {
+  int number_of_opening_plays = test_board_dim_movegen();
+#ifdef SUPER_CROSSWORD_GAME_VARIANT
+  // The opening plays fit on either board.
+  assert(super_test_board_dim_movegen() == number_of_opening_plays);
+  test_ucgi_board_dim_dispatch();
+#else
+  (void)number_of_opening_plays;
+#endif
+}
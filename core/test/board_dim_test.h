@@ -0,0 +1,6 @@
+#ifndef BOARD_DIM_TEST_H
+#define BOARD_DIM_TEST_H
+
+void test_board_dim();
+
+#endif
\ No newline at end of file
@@ -15,16 +15,17 @@ void test_board_cross_set_for_cross_set_index(Game *game, int cross_set_index) {
   // Test cross set
   clear_cross_set(game->gen->board, 0, 0, BOARD_HORIZONTAL_DIRECTION,
                   cross_set_index);
-  set_cross_set_letter(get_cross_set_pointer(game->gen->board, 0, 0,
-                                             BOARD_HORIZONTAL_DIRECTION,
-                                             cross_set_index),
-                       13);
+  uint64_t cross_set = get_cross_set(game->gen->board, 0, 0,
+                                     BOARD_HORIZONTAL_DIRECTION,
+                                     cross_set_index);
+  set_cross_set_letter(&cross_set, 13);
+  set_cross_set(game->gen->board, 0, 0, cross_set, BOARD_HORIZONTAL_DIRECTION,
+                cross_set_index);
   assert(get_cross_set(game->gen->board, 0, 0, BOARD_HORIZONTAL_DIRECTION,
                        cross_set_index) == 8192);
-  set_cross_set_letter(get_cross_set_pointer(game->gen->board, 0, 0,
-                                             BOARD_HORIZONTAL_DIRECTION,
-                                             cross_set_index),
-                       0);
+  set_cross_set_letter(&cross_set, 0);
+  set_cross_set(game->gen->board, 0, 0, cross_set, BOARD_HORIZONTAL_DIRECTION,
+                cross_set_index);
   assert(get_cross_set(game->gen->board, 0, 0, BOARD_HORIZONTAL_DIRECTION,
                        cross_set_index) == 8193);
 
@@ -49,6 +50,20 @@ void test_board(SuperConfig *superconfig) {
   assert(get_anchor(game->gen->board, 4, 3, 1) &&
          !get_anchor(game->gen->board, 4, 3, 0));
 
+  // The anchors of a line are the anchors of its squares
+  // along the line in the current view.
+  for (int transposed = 0; transposed < 2; transposed++) {
+    set_transpose(game->gen->board, transposed);
+    for (int row = 0; row < BOARD_DIM; row++) {
+      uint32_t line_anchors = get_line_anchors(game->gen->board, row);
+      for (int col = 0; col < BOARD_DIM; col++) {
+        assert((int)((line_anchors >> col) & 1) ==
+               get_anchor(game->gen->board, row, col, transposed));
+      }
+    }
+  }
+  reset_transpose(game->gen->board);
+
   test_board_cross_set_for_cross_set_index(game, 0);
   test_board_cross_set_for_cross_set_index(game, 1);
   destroy_game(game);
@@ -2,6 +2,7 @@
 #include <stddef.h>
 
 #include "../src/config.h"
+#include "../src/game.h"
 
 #include "config_test.h"
 
@@ -9,12 +10,19 @@ void test_config_empty_string_klv2() {
   Config *config = create_config(
       "./data/letterdistributions/english.csv", "", "./data/lexica/CSW21.kwg",
       "./data/lexica/CSW21.klv2", SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL, "",
-      "", -1, -1, 0, 3, 0, 0, NULL, 0, 0, 0, 0, 1, "", MOVE_LIST_CAPACITY);
+      "", -1, -1, 0, 3, 0, 0, NULL, 0, 0, 0, 0, 1, "", MOVE_LIST_CAPACITY,
+      KWG_LOAD_MODE_MMAP, 0, 16, 1);
 
   assert(config->klv_is_shared);
   assert(config->kwg_is_shared);
   assert(!config->use_game_pairs);
   assert(config->number_of_games_or_pairs == 3);
+  assert(config->leave_cache_capacity == 16);
+  assert(config->defer_blank_designations);
+  Game *game = create_game(config);
+  assert(game->gen->leave_cache_capacity == 16);
+  assert(game->gen->defer_blank_designations);
+  destroy_game(game);
   config->player_1_strategy_params->klv->word_counts[0] = 3000;
   config->player_2_strategy_params->klv->word_counts[0] = 4000;
   assert(config->player_1_strategy_params->klv->word_counts[0] == 4000);
@@ -27,7 +35,8 @@ void test_config_identical_klv2() {
       "./data/letterdistributions/english.csv", "", "./data/lexica/CSW21.kwg",
       "./data/lexica/CSW21.klv2", SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL,
       "./data/lexica/CSW21.kwg", "./data/lexica/CSW21.klv2", -1, -1, 0, 10000,
-      0, 0, NULL, 0, 0, 0, 0, 1, "", MOVE_LIST_CAPACITY);
+      0, 0, NULL, 0, 0, 0, 0, 1, "", MOVE_LIST_CAPACITY, KWG_LOAD_MODE_MMAP, 0,
+      LEAVE_CACHE_SIZE, 0);
 
   assert(config->klv_is_shared);
   assert(config->kwg_is_shared);
@@ -44,11 +53,13 @@ void test_config_different_klv2() {
       "./data/letterdistributions/english.csv", "", "./data/lexica/CSW21.kwg",
       "./data/lexica/CSW21.klv2", SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL,
       "./data/lexica/NWL20.kwg", "./data/lexica/english.klv2", -1, -1, 1, 10000,
-      0, 0, NULL, 0, 0, 0, 0, 1, "", MOVE_LIST_CAPACITY);
+      0, 0, NULL, 0, 0, 0, 0, 1, "", MOVE_LIST_CAPACITY, KWG_LOAD_MODE_COPY, 0,
+      LEAVE_CACHE_SIZE, 0);
 
   assert(!config->klv_is_shared);
   assert(!config->kwg_is_shared);
   assert(config->use_game_pairs);
+  assert(config->kwg_load_mode == KWG_LOAD_MODE_COPY);
   config->player_1_strategy_params->klv->word_counts[0] = 3000;
   config->player_2_strategy_params->klv->word_counts[0] = 4000;
   assert(config->player_1_strategy_params->klv->word_counts[0] == 3000);
@@ -7,7 +7,10 @@
 #include "../src/cross_set.h"
 #include "../src/game.h"
 #include "../src/letter_distribution.h"
+#include "../src/movegen.h"
+#include "../src/player.h"
 
+#include "move_print.h"
 #include "superconfig.h"
 #include "test_constants.h"
 #include "test_util.h"
@@ -157,6 +160,15 @@ void test_cross_set(SuperConfig *superconfig) {
   test_gen_cross_set_row(game, 4, 1, 1, 0, "T UNFOLD", "", 11, 1);
   test_gen_cross_set_row(game, 4, 1, 1, 0, "S OBCONIc", "", 11, 1);
 
+  // Squares between words that were seen before are found in the cache.
+  CrossSetCache *cross_set_cache = get_cross_set_cache(game->gen->board);
+  uint64_t hits = cross_set_cache->hits;
+  uint64_t misses = cross_set_cache->misses;
+  test_gen_cross_set_row(game, 4, 1, 1, 0, "R XED", "A", 12, 1);
+  test_gen_cross_set_row(game, 4, 2, 0, 0, "BA ED", "AKLNRSTY", 7, 1);
+  assert(cross_set_cache->hits == hits + 2);
+  assert(cross_set_cache->misses == misses);
+
   // TestGenAllcross_sets
   reset_game(game);
   load_cgp(game, VS_ED);
@@ -194,5 +206,28 @@ void test_cross_set(SuperConfig *superconfig) {
   assert(get_cross_set(game->gen->board, 7, 10, BOARD_VERTICAL_DIRECTION, 0) ==
          0);
 
+  // Loading a position again finds the squares between its words in
+  // the cache, and the cached cross sets give the same plays.
+  reset_game(game);
+  load_cgp(game, VS_JEREMY);
+  hits = cross_set_cache->hits;
+  reset_game(game);
+  load_cgp(game, VS_JEREMY);
+  assert(cross_set_cache->hits > hits);
+
+  Player *player = game->players[0];
+  set_rack_to_string(player->rack, "DDESW??", game->gen->letter_distribution);
+  generate_moves(game->gen, player, NULL, 0);
+  assert(game->gen->move_list->count == 8286);
+  SortedMoveList *sorted_move_list =
+      create_sorted_move_list(game->gen->move_list);
+  char test_string[100];
+  reset_string(test_string);
+  write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
+                                           sorted_move_list->moves[0],
+                                           game->gen->letter_distribution);
+  assert_strings_equal(test_string, "14B hEaDW(OR)DS 106");
+  destroy_sorted_move_list(sorted_move_list);
+
   destroy_game(game);
 }
\ No newline at end of file
@@ -74,10 +74,10 @@ void print_game(Game *game) {
     } else if (i - 2 < game->gen->move_list->count) {
       char move_string[24] = "";
       write_user_visible_move_to_end_of_buffer(
-          move_string, game->gen->board, game->gen->move_list->moves[i - 2],
+          move_string, game->gen->board, &game->gen->move_list->moves[i - 2],
           game->gen->letter_distribution);
       sprintf(gs + strlen(gs), " %-3d %-24s %0.2f", i - 1, move_string,
-              game->gen->move_list->moves[i - 2]->equity);
+              game->gen->move_list->moves[i - 2].equity);
     }
     write_string_to_end_of_buffer(gs, "\n");
   }
@@ -4,6 +4,8 @@
 
 #include "../src/config.h"
 #include "../src/game.h"
+#include "../src/gameplay.h"
+#include "../src/zobrist.h"
 #include "game_test.h"
 #include "rack_test.h"
 #include "test_constants.h"
@@ -98,8 +100,72 @@ void test_lexicon_ld_from_cgp() {
   assert(strcmp(ldname, "messedupenglish") == 0);
 }
 
+uint64_t compute_board_hash(Board *board) {
+  uint64_t hash = 0;
+  for (int i = 0; i < BOARD_DIM * BOARD_DIM; i++) {
+    hash ^= get_square_key(i, board->letters[i]);
+  }
+  return hash;
+}
+
+uint64_t compute_rack_hash(Rack *rack) {
+  uint64_t hash = 0;
+  for (int i = 0; i < rack->array_size; i++) {
+    hash += rack->array[i] * get_rack_letter_key(i);
+  }
+  return hash;
+}
+
+void assert_hashes_are_recomputed(Game *game) {
+  assert(board_hash(game->gen->board) == compute_board_hash(game->gen->board));
+  assert(game->players[0]->rack->hash ==
+         compute_rack_hash(game->players[0]->rack));
+  assert(game->players[1]->rack->hash ==
+         compute_rack_hash(game->players[1]->rack));
+}
+
+void test_game_hash(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+  assert(board_hash(game->gen->board) == 0);
+  for (int i = 0; i < MAX_ALPHABET_SIZE; i++) {
+    assert(get_rack_letter_key(i) == zobrist_mix(ZOBRIST_RACK_SEED + i));
+  }
+
+  reset_and_load_game(game, DOUG_V_EMELY_CGP);
+  assert_hashes_are_recomputed(game);
+  uint64_t hash = game_hash(game);
+
+  set_backup_mode(game, BACKUP_MODE_SIMULATION);
+  play_top_n_equity_move(game, 0);
+  assert_hashes_are_recomputed(game);
+  assert(game_hash(game) != hash);
+  set_backup_mode(game, BACKUP_MODE_OFF);
+  for (int i = 0; i < 4 && game->game_end_reason == GAME_END_REASON_NONE;
+       i++) {
+    play_top_n_equity_move(game, 0);
+    assert_hashes_are_recomputed(game);
+  }
+  unplay_last_move(game);
+  assert_hashes_are_recomputed(game);
+  assert(game_hash(game) == hash);
+
+  Game *game_copy = copy_game(game, 1);
+  assert(game_hash(game_copy) == hash);
+  destroy_game(game_copy);
+
+  // The order of the tiles in the bag is not part of the position.
+  reset_and_load_game(game, DOUG_V_EMELY_CGP);
+  assert(game_hash(game) == hash);
+  set_player_on_turn(game, 1 - game->player_on_turn_index);
+  assert(game_hash(game) != hash);
+
+  destroy_game(game);
+}
+
 void test_game(SuperConfig *superconfig) {
   test_game_main(superconfig);
   test_load_cgp(superconfig);
   test_lexicon_ld_from_cgp();
+  test_game_hash(superconfig);
 }
\ No newline at end of file
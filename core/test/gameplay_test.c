@@ -10,6 +10,7 @@
 
 #include "game_print.h"
 #include "superconfig.h"
+#include "test_constants.h"
 #include "test_util.h"
 
 void return_rack_to_bag(Rack *rack, Bag *bag) {
@@ -43,7 +44,17 @@ void assert_boards_are_equal(Board *b1, Board *b2) {
     }
     assert(b1->cross_sets[i] == b2->cross_sets[i]);
     assert(b1->cross_scores[i] == b2->cross_scores[i]);
-    assert(b1->anchors[i] == b2->anchors[i]);
+    if (i < BOARD_DIM * BOARD_DIM) {
+      assert(b1->transposed_letters[i] == b2->transposed_letters[i]);
+    }
+    assert(b1->transposed_cross_sets[i] == b2->transposed_cross_sets[i]);
+    assert(b1->transposed_cross_scores[i] == b2->transposed_cross_scores[i]);
+  }
+  for (int dir = 0; dir < 2; dir++) {
+    for (int i = 0; i < BOARD_DIM; i++) {
+      assert(b1->occupancy[dir][i] == b2->occupancy[dir][i]);
+      assert(b1->anchors[dir][i] == b2->anchors[dir][i]);
+    }
   }
 }
 
@@ -569,6 +580,56 @@ void test_backups(SuperConfig *superconfig) {
   destroy_game(game);
 }
 
+void test_backups_undo_later_moves(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+  load_cgp(game, DOUG_V_EMELY_CGP);
+  Board *board = copy_board(game->gen->board);
+  Bag *bag = copy_bag(game->gen->bag);
+  Rack *rack = create_rack(game->players[0]->rack->array_size);
+  copy_rack_into(rack, game->players[0]->rack);
+  int player_on_turn_index = game->player_on_turn_index;
+
+  // Only the first move is backed up, as in a simulation,
+  // but unplaying it also undoes the moves played after it.
+  set_backup_mode(game, BACKUP_MODE_SIMULATION);
+  play_top_n_equity_move(game, 0);
+  // Writes that change nothing are not journaled.
+  Board *game_board = game->gen->board;
+  int number_of_entries = game->undo_log->number_of_entries;
+  set_letter(game_board, 7, 7, get_letter(game_board, 7, 7));
+  set_cross_set(game_board, 7, 8, get_cross_set(game_board, 7, 8, 0, 0), 0,
+                0);
+  set_cross_score(game_board, 7, 8, get_cross_score(game_board, 7, 8, 0, 0),
+                  0, 0);
+  assert(game->undo_log->number_of_entries == number_of_entries);
+  set_backup_mode(game, BACKUP_MODE_OFF);
+  set_random_rack(game, 0, NULL);
+  for (int i = 0; i < 4 && game->game_end_reason == GAME_END_REASON_NONE;
+       i++) {
+    play_top_n_equity_move(game, 0);
+  }
+  assert(game->undo_log->number_of_entries > 0);
+  unplay_last_move(game);
+
+  assert(game->backup_cursor == 0);
+  assert(game->undo_log->number_of_entries == 0);
+  assert(!game->gen->board->undo_log);
+  assert(!game->gen->bag->undo_log);
+  assert_boards_are_equal(game->gen->board, board);
+  // The tiles are restored in order, so later draws are the same.
+  assert(game->gen->bag->last_tile_index == bag->last_tile_index);
+  assert(!memcmp(game->gen->bag->tiles, bag->tiles, bag->last_tile_index + 1));
+  assert(!memcmp(game->gen->bag->prng->s, bag->prng->s, sizeof(bag->prng->s)));
+  assert(racks_are_equal(game->players[0]->rack, rack));
+  assert(game->player_on_turn_index == player_on_turn_index);
+
+  destroy_rack(rack);
+  destroy_bag(bag);
+  destroy_board(board);
+  destroy_game(game);
+}
+
 void test_gameplay(SuperConfig *superconfig) {
   test_playmove(superconfig);
   test_six_exchanges_game(superconfig);
@@ -576,4 +637,5 @@ void test_gameplay(SuperConfig *superconfig) {
   test_standard_game(superconfig);
   test_set_random_rack(superconfig);
   test_backups(superconfig);
+  test_backups_undo_later_moves(superconfig);
 }
\ No newline at end of file
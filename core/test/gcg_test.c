@@ -91,6 +91,8 @@ void test_error_cases() {
                          GCG_PARSE_STATUS_REDUNDANT_PRAGMA);
   test_single_error_case("game_events_overflow.gcg",
                          GCG_PARSE_STATUS_GAME_EVENTS_OVERFLOW);
+  test_single_error_case("unsupported_board_layout.gcg",
+                         GCG_PARSE_STATUS_UNSUPPORTED_BOARD_LAYOUT);
 }
 
 void test_parse_special_char() {
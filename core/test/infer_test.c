@@ -219,6 +219,8 @@ void test_infer_nonerror_cases(SuperConfig *superconfig,
   status =
       infer_for_test(inference, game, rack, 0, 52, 0, 0, number_of_threads);
   assert(status == INFERENCE_STATUS_SUCCESS);
+  // Every evaluated rack is looked up in the leave cache.
+  assert(inference->leave_cache_hits + inference->leave_cache_misses > 0);
   // With this rack, only keeping an S is possible, and
   // there are 3 S remaining.
   assert(get_weight(inference->leave_record->equity_values) == 3);
@@ -450,8 +452,7 @@ void test_infer_nonerror_cases(SuperConfig *superconfig,
   // more combinatorics
   load_cgp(game, OOPSYCHOLOGY_CGP);
   set_rack_to_string(rack, "IIII", game->gen->letter_distribution);
-  // Empty the bag
-  game->gen->bag->last_tile_index = -1;
+  empty_bag(game->gen->bag);
   add_letter(game->gen->bag, human_readable_letter_to_machine_letter(
                                  game->gen->letter_distribution, "I"));
   add_letter(game->gen->bag, human_readable_letter_to_machine_letter(
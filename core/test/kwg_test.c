@@ -0,0 +1,239 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/config.h"
+#include "../src/constants.h"
+#include "../src/game.h"
+#include "../src/kwg.h"
+#include "../src/movegen.h"
+#include "../src/player.h"
+
+#include "move_print.h"
+#include "superconfig.h"
+#include "test_constants.h"
+#include "test_util.h"
+
+void test_kwg_load_modes(const char *kwg_filename) {
+  KWG *copied_kwg =
+      create_kwg_with_load_mode(kwg_filename, KWG_LOAD_MODE_COPY);
+  KWG *mapped_kwg =
+      create_kwg_with_load_mode(kwg_filename, KWG_LOAD_MODE_MMAP);
+
+  assert(!copied_kwg->is_mapped);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  assert(mapped_kwg->is_mapped);
+#endif
+  assert(copied_kwg->number_of_nodes > 0);
+  assert(copied_kwg->number_of_nodes == mapped_kwg->number_of_nodes);
+  assert(memcmp(copied_kwg->nodes, mapped_kwg->nodes,
+                copied_kwg->number_of_nodes * sizeof(uint32_t)) == 0);
+  assert(kwg_get_root_node_index(copied_kwg) ==
+         kwg_get_root_node_index(mapped_kwg));
+  // The index is only built on request.
+  assert(!mapped_kwg->letter_masks);
+  assert(!mapped_kwg->front_hooks && !mapped_kwg->back_hooks);
+  assert(!mapped_kwg->subtree_letter_masks);
+  assert(!mapped_kwg->min_remaining_lengths);
+  assert(!kwg_subtree_is_unplayable(mapped_kwg,
+                                    kwg_get_root_node_index(mapped_kwg), 0, 0));
+
+  destroy_kwg(copied_kwg);
+  destroy_kwg(mapped_kwg);
+}
+
+void test_kwg_letter_masks(KWG *kwg) {
+  assert(kwg->letter_masks);
+  for (size_t i = 0; i < kwg->number_of_nodes; i++) {
+    int tile = kwg_tile(kwg, i);
+    assert(kwg_get_letter_mask(kwg, i) & ((uint64_t)1 << tile));
+    assert(kwg_get_letter_node_index(kwg, i, tile) == (int)i);
+  }
+
+  // Compare the indexed lookups against a linear scan of the siblings.
+  uint64_t *letter_masks = kwg->letter_masks;
+  int root_node_index = kwg_get_root_node_index(kwg);
+  int indexed_results[MAX_ALPHABET_SIZE];
+  for (int letter = 0; letter < MAX_ALPHABET_SIZE; letter++) {
+    indexed_results[letter] =
+        kwg_get_letter_node_index(kwg, root_node_index, letter);
+  }
+  kwg->letter_masks = NULL;
+  for (int letter = 0; letter < MAX_ALPHABET_SIZE; letter++) {
+    assert(kwg_get_letter_node_index(kwg, root_node_index, letter) ==
+           indexed_results[letter]);
+  }
+  kwg->letter_masks = letter_masks;
+}
+
+void test_kwg_hooks(KWG *kwg) {
+  assert(kwg->front_hooks && kwg->back_hooks);
+  for (size_t i = 0; i < kwg->number_of_nodes; i++) {
+    assert(kwg_get_front_hooks(kwg, i) ==
+           (uint64_t)kwg_get_letter_set(kwg, i));
+    assert(kwg_get_back_hooks(kwg, i) ==
+           (uint64_t)kwg_get_letter_set(
+               kwg, kwg_get_next_node_index(kwg, i,
+                                            SEPARATION_MACHINE_LETTER)));
+  }
+}
+
+void test_kwg_subtree_summaries(KWG *kwg) {
+  assert(kwg->subtree_letter_masks && kwg->min_remaining_lengths);
+  for (size_t i = 0; i < kwg->number_of_nodes; i++) {
+    uint64_t letter_mask = kwg->subtree_letter_masks[i];
+    int min_remaining_length = kwg->min_remaining_lengths[i];
+    assert(letter_mask & ((uint64_t)1 << kwg_tile(kwg, i)));
+    if (kwg_accepts(kwg, i)) {
+      assert(min_remaining_length <= 1);
+    }
+    int arc_index = kwg_arc_index(kwg, i);
+    if (arc_index != 0) {
+      assert((kwg->subtree_letter_masks[arc_index] & ~letter_mask) == 0);
+      assert(min_remaining_length <=
+             kwg->min_remaining_lengths[arc_index] + 1);
+    }
+    if (!kwg_is_end(kwg, i)) {
+      assert((kwg->subtree_letter_masks[i + 1] & ~letter_mask) == 0);
+      assert(min_remaining_length <= kwg->min_remaining_lengths[i + 1]);
+    }
+  }
+  // The shortest words have two letters.
+  assert(kwg->min_remaining_lengths[kwg_arc_index(kwg, 0)] == 2);
+  assert(kwg->min_remaining_lengths[kwg_get_root_node_index(kwg)] == 2);
+  assert(!kwg_subtree_is_unplayable(kwg, kwg_get_root_node_index(kwg),
+                                    ~(uint64_t)0, 2));
+  assert(kwg_subtree_is_unplayable(kwg, kwg_get_root_node_index(kwg),
+                                   ~(uint64_t)0, 1));
+  assert(kwg_subtree_is_unplayable(kwg, kwg_get_root_node_index(kwg), 0,
+                                   RACK_SIZE));
+}
+
+// Returns the number of accepted paths starting at the siblings of
+// node_index, memoized by node since groups are shared.
+uint64_t count_kwg_words(KWG *kwg, int node_index, uint64_t *counts) {
+  if (counts[node_index] != UINT64_MAX) {
+    return counts[node_index];
+  }
+  uint64_t count = kwg_accepts(kwg, node_index);
+  int arc_index = kwg_arc_index(kwg, node_index);
+  if (arc_index != 0) {
+    count += count_kwg_words(kwg, arc_index, counts);
+  }
+  if (!kwg_is_end(kwg, node_index)) {
+    count += count_kwg_words(kwg, node_index + 1, counts);
+  }
+  counts[node_index] = count;
+  return count;
+}
+
+void count_dawg_and_gaddag_words(KWG *kwg, uint64_t *dawg_count,
+                                 uint64_t *gaddag_count) {
+  uint64_t *counts = malloc(kwg->number_of_nodes * sizeof(uint64_t));
+  for (size_t i = 0; i < kwg->number_of_nodes; i++) {
+    counts[i] = UINT64_MAX;
+  }
+  *dawg_count = count_kwg_words(kwg, kwg_arc_index(kwg, 0), counts);
+  *gaddag_count = count_kwg_words(kwg, kwg_get_root_node_index(kwg), counts);
+  free(counts);
+}
+
+void test_kwg_relayout(const char *kwg_filename) {
+  KWG *kwg = create_kwg_with_load_mode(kwg_filename, KWG_LOAD_MODE_COPY);
+  KWG *relayout_kwg =
+      create_kwg_with_load_mode(kwg_filename, KWG_LOAD_MODE_RELAYOUT);
+  assert(!relayout_kwg->is_mapped);
+  assert(kwg->number_of_nodes == relayout_kwg->number_of_nodes);
+
+  uint64_t dawg_count;
+  uint64_t gaddag_count;
+  uint64_t relayout_dawg_count;
+  uint64_t relayout_gaddag_count;
+  count_dawg_and_gaddag_words(kwg, &dawg_count, &gaddag_count);
+  count_dawg_and_gaddag_words(relayout_kwg, &relayout_dawg_count,
+                              &relayout_gaddag_count);
+  assert(dawg_count > 0);
+  assert(dawg_count == relayout_dawg_count);
+  assert(gaddag_count == relayout_gaddag_count);
+
+  // The root siblings are the first group after the root pointers.
+  assert(kwg_get_root_node_index(relayout_kwg) <=
+         kwg_arc_index(relayout_kwg, 0));
+  build_kwg_index(relayout_kwg);
+  test_kwg_letter_masks(relayout_kwg);
+  test_kwg_hooks(relayout_kwg);
+  test_kwg_subtree_summaries(relayout_kwg);
+
+  destroy_kwg(kwg);
+  destroy_kwg(relayout_kwg);
+}
+
+void assert_top_move_for_kwg(Game *game, KWG *kwg, int expected_count,
+                             const char *expected_move) {
+  for (int i = 0; i < 2; i++) {
+    game->players[i]->strategy_params->kwg = kwg;
+  }
+  Player *player = game->players[0];
+  generate_moves(game->gen, player, NULL, 0);
+  assert(game->gen->move_list->count == expected_count);
+
+  SortedMoveList *sorted_move_list =
+      create_sorted_move_list(game->gen->move_list);
+  char test_string[100];
+  reset_string(test_string);
+  write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
+                                           sorted_move_list->moves[0],
+                                           game->gen->letter_distribution);
+  assert_strings_equal(test_string, (char *)expected_move);
+  destroy_sorted_move_list(sorted_move_list);
+}
+
+// Generates the same position with the indexed kwg of the config
+// and with an unindexed copy of it, which must find the same moves.
+void test_kwg_index_generation(Config *config, const char *cgp,
+                               const char *rack_string, int expected_count,
+                               const char *expected_move) {
+  KWG *indexed_kwg = config->player_1_strategy_params->kwg;
+  assert(indexed_kwg->letter_masks);
+  KWG *unindexed_kwg = create_kwg_with_load_mode(
+      config->player_1_strategy_params->kwg_filename, KWG_LOAD_MODE_COPY);
+  assert(!unindexed_kwg->letter_masks);
+
+  Game *game = create_game(config);
+  load_cgp(game, cgp);
+  Player *player = game->players[0];
+  set_rack_to_string(player->rack, rack_string,
+                     game->gen->letter_distribution);
+
+  assert_top_move_for_kwg(game, indexed_kwg, expected_count, expected_move);
+  assert_top_move_for_kwg(game, unindexed_kwg, expected_count,
+                          expected_move);
+
+  for (int i = 0; i < 2; i++) {
+    game->players[i]->strategy_params->kwg = indexed_kwg;
+  }
+  destroy_game(game);
+  destroy_kwg(unindexed_kwg);
+}
+
+void test_kwg(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  test_kwg_load_modes(config->player_1_strategy_params->kwg_filename);
+  test_kwg_letter_masks(config->player_1_strategy_params->kwg);
+  test_kwg_hooks(config->player_1_strategy_params->kwg);
+  test_kwg_subtree_summaries(config->player_1_strategy_params->kwg);
+  test_kwg_relayout(config->player_1_strategy_params->kwg_filename);
+
+  // The nwl config relays out its kwg and builds the index, so that
+  // both are checked against a second lexicon and the unindexed copy.
+  Config *nwl_config = get_nwl_config(superconfig);
+  test_kwg_letter_masks(nwl_config->player_1_strategy_params->kwg);
+  test_kwg_hooks(nwl_config->player_1_strategy_params->kwg);
+  test_kwg_subtree_summaries(nwl_config->player_1_strategy_params->kwg);
+  // The pass is the one nonscoring play.
+  test_kwg_index_generation(nwl_config, VS_JEREMY, "DDESW??", 8286,
+                            "14B hEaDW(OR)DS 106");
+  test_kwg_index_generation(nwl_config, VS_OXY, "ABEOPXZ", 514,
+                            "A1 OX(Y)P(HEN)B(UT)AZ(ON)E 1780");
+}
@@ -0,0 +1,8 @@
+#ifndef KWG_TEST_H
+#define KWG_TEST_H
+
+#include "superconfig.h"
+
+void test_kwg(SuperConfig *superconfig);
+
+#endif
@@ -37,6 +37,12 @@ void test_leaves(SuperConfig *superconfig, const char *leaves_csv_filename) {
     free(leave);
   }
 
+  // The CSW leaves fit in the rank table, and racks
+  // too long to be leaves are worth nothing.
+  assert(klv->leave_values_by_rank);
+  set_rack_to_string(rack, "AEINRST", letter_distribution);
+  assert(get_leave_value(klv, rack) == 0.0);
+
   destroy_rack(rack);
   fclose(file);
 }
\ No newline at end of file
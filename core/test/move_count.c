@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/config.h"
+#include "../src/constants.h"
+#include "../src/game.h"
+#include "../src/letter_distribution.h"
+#include "../src/movegen.h"
+
+#include "move_count.h"
+#include "test_constants.h"
+#include "test_util.h"
+
+// Positions counted when no cgp is given on the command line.
+static const char *move_count_corpus[] = {
+    OPENING_CGP,  DOUG_V_EMELY_CGP, GUY_VS_BOT_CGP, NOAH_VS_MISHU_CGP,
+    VS_ED,        VS_JEREMY,        VS_MATT,        VS_OXY,
+    MANY_MOVES,   UEY_CGP,
+};
+
+typedef struct MoveCounts {
+  // Indexed by the number of tiles placed on the board
+  uint64_t plays[RACK_SIZE + 1];
+  // Indexed by the number of tiles exchanged
+  uint64_t exchanges[RACK_SIZE + 1];
+  uint64_t plays_using_blank;
+  uint64_t exchanges_using_blank;
+  // Not a count, but cheap to compare across builds
+  // to catch moves that are found with the wrong score.
+  uint64_t score_sum;
+#ifdef MOVEGEN_STATS
+  // Copied from the generator, which only counts
+  // these in builds with MOVEGEN_STATS defined.
+  uint64_t subtrees_searched;
+  uint64_t subtrees_pruned;
+#endif
+} MoveCounts;
+
+static void count_visited_move(const uint8_t *tiles, int number_of_tiles,
+                               int row, int col, int vertical,
+                               int tiles_played, int move_type, int score,
+                               double leave_value, void *visitor_data) {
+  (void)row;
+  (void)col;
+  (void)vertical;
+  (void)leave_value;
+  MoveCounts *counts = (MoveCounts *)visitor_data;
+  int uses_blank = 0;
+  if (move_type == MOVE_TYPE_PLAY) {
+    for (int i = 0; i < number_of_tiles; i++) {
+      if (tiles[i] != PLAYED_THROUGH_MARKER && is_blanked(tiles[i])) {
+        uses_blank = 1;
+        break;
+      }
+    }
+    counts->plays[tiles_played]++;
+    counts->plays_using_blank += uses_blank;
+  } else {
+    for (int i = 0; i < number_of_tiles; i++) {
+      if (tiles[i] == BLANK_MACHINE_LETTER) {
+        uses_blank = 1;
+        break;
+      }
+    }
+    counts->exchanges[tiles_played]++;
+    counts->exchanges_using_blank += uses_blank;
+  }
+  counts->score_sum += score;
+}
+
+static uint64_t total_plays(const MoveCounts *counts) {
+  uint64_t total = 0;
+  for (int i = 0; i <= RACK_SIZE; i++) {
+    total += counts->plays[i];
+  }
+  return total;
+}
+
+static uint64_t total_exchanges(const MoveCounts *counts) {
+  uint64_t total = 0;
+  for (int i = 0; i <= RACK_SIZE; i++) {
+    total += counts->exchanges[i];
+  }
+  return total;
+}
+
+static void add_move_counts(MoveCounts *total, const MoveCounts *counts) {
+  for (int i = 0; i <= RACK_SIZE; i++) {
+    total->plays[i] += counts->plays[i];
+    total->exchanges[i] += counts->exchanges[i];
+  }
+  total->plays_using_blank += counts->plays_using_blank;
+  total->exchanges_using_blank += counts->exchanges_using_blank;
+  total->score_sum += counts->score_sum;
+#ifdef MOVEGEN_STATS
+  total->subtrees_searched += counts->subtrees_searched;
+  total->subtrees_pruned += counts->subtrees_pruned;
+#endif
+}
+
+static void print_move_counts(const char *label, const MoveCounts *counts,
+                              double nanoseconds) {
+  printf("%s: %llu plays, %llu exchanges, %llu score sum, %0.0f ns\n", label,
+         (unsigned long long)total_plays(counts),
+         (unsigned long long)total_exchanges(counts),
+         (unsigned long long)counts->score_sum, nanoseconds);
+  printf("  plays by tiles played:");
+  for (int i = 1; i <= RACK_SIZE; i++) {
+    printf(" %llu", (unsigned long long)counts->plays[i]);
+  }
+  printf("\n  exchanges by tiles exchanged:");
+  for (int i = 1; i <= RACK_SIZE; i++) {
+    printf(" %llu", (unsigned long long)counts->exchanges[i]);
+  }
+  printf("\n  using blank: %llu plays, %llu exchanges\n",
+         (unsigned long long)counts->plays_using_blank,
+         (unsigned long long)counts->exchanges_using_blank);
+#ifdef MOVEGEN_STATS
+  printf("  subtrees: %llu searched, %llu pruned\n",
+         (unsigned long long)counts->subtrees_searched,
+         (unsigned long long)counts->subtrees_pruned);
+#endif
+}
+
+static double elapsed_nanoseconds(const struct timespec *begin,
+                                  const struct timespec *end) {
+  return (double)(end->tv_sec - begin->tv_sec) * 1e9 +
+         (double)(end->tv_nsec - begin->tv_nsec);
+}
+
+// Counts every legal tile placement and exchange (but not the pass) of
+// each position without building a move list, in the spirit of a chess
+// perft. The counts are independent of the recorder and the leave values,
+// so they can be diffed across builds to validate move generator changes.
+// The timings cover the whole generation short of recording moves: the
+// board and KWG traversal, but also exchange generation and the visitor
+// calls. Build with STATS=1 to also report the KWG subtrees searched and
+// pruned, which costs time in the innermost loop.
+void count_moves(Config *config) {
+  Game *game = create_game(config);
+  int iterations = config->number_of_games_or_pairs;
+  if (iterations < 1) {
+    iterations = 1;
+  }
+
+  const char **cgps = move_count_corpus;
+  int number_of_cgps = sizeof(move_count_corpus) / sizeof(*move_count_corpus);
+  const char *config_cgp = config->cgp;
+  if (strlen(config_cgp) > 0) {
+    cgps = &config_cgp;
+    number_of_cgps = 1;
+  }
+
+  for (int i = 0; i < 2; i++) {
+    game->players[i]->strategy_params->play_recorder_type =
+        PLAY_RECORDER_TYPE_VISITOR;
+  }
+
+  MoveCounts total_counts;
+  memset(&total_counts, 0, sizeof(MoveCounts));
+  double total_nanoseconds = 0;
+  char label[20];
+
+  for (int i = 0; i < number_of_cgps; i++) {
+    reset_game(game);
+    load_cgp(game, cgps[i]);
+    MoveCounts counts;
+    memset(&counts, 0, sizeof(MoveCounts));
+    set_move_visitor(game->gen, count_visited_move, &counts);
+    generate_moves_for_game(game);
+#ifdef MOVEGEN_STATS
+    counts.subtrees_searched = game->gen->subtrees_searched;
+    counts.subtrees_pruned = game->gen->subtrees_pruned;
+#endif
+
+    // Time the repetitions separately so that the reported counts
+    // are those of a single generation.
+    MoveCounts scratch_counts;
+    memset(&scratch_counts, 0, sizeof(MoveCounts));
+    set_move_visitor(game->gen, count_visited_move, &scratch_counts);
+    struct timespec begin;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (int j = 0; j < iterations; j++) {
+      generate_moves_for_game(game);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double nanoseconds = elapsed_nanoseconds(&begin, &end) / iterations;
+
+    sprintf(label, "position %d", i + 1);
+    print_move_counts(label, &counts, nanoseconds);
+    add_move_counts(&total_counts, &counts);
+    total_nanoseconds += nanoseconds;
+  }
+
+  print_move_counts("total", &total_counts, total_nanoseconds);
+  printf("%0.0f ns per position\n", total_nanoseconds / number_of_cgps);
+
+  set_move_visitor(game->gen, NULL, NULL);
+  destroy_game(game);
+}
@@ -0,0 +1,8 @@
+#ifndef MOVE_COUNT_H
+#define MOVE_COUNT_H
+
+#include "../src/config.h"
+
+void count_moves(Config *config);
+
+#endif
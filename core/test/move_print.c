@@ -78,7 +78,7 @@ void write_user_visible_move_to_end_of_buffer(
 void write_move_list_to_end_of_buffer(char *buf, MoveList *ml, Board *b,
                                       LetterDistribution *letter_distribution) {
   for (int i = 0; i < ml->count; i++) {
-    write_user_visible_move_to_end_of_buffer(buf, b, ml->moves[i],
+    write_user_visible_move_to_end_of_buffer(buf, b, &ml->moves[i],
                                              letter_distribution);
     write_string_to_end_of_buffer(buf, "\n");
   }
@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "../src/bag.h"
@@ -23,7 +24,7 @@
 int count_scoring_plays(MoveList *ml) {
   int sum = 0;
   for (int i = 0; i < ml->count; i++) {
-    if (ml->moves[i]->move_type == MOVE_TYPE_PLAY) {
+    if (ml->moves[i].move_type == MOVE_TYPE_PLAY) {
       sum++;
     }
   }
@@ -33,7 +34,7 @@ int count_scoring_plays(MoveList *ml) {
 int count_nonscoring_plays(MoveList *ml) {
   int sum = 0;
   for (int i = 0; i < ml->count; i++) {
-    if (ml->moves[i]->move_type != MOVE_TYPE_PLAY) {
+    if (ml->moves[i].move_type != MOVE_TYPE_PLAY) {
       sum++;
     }
   }
@@ -130,17 +131,17 @@ void macondo_tests(SuperConfig *superconfig) {
       game->gen->letter_distribution, "I");
   clear_cross_set(game->gen->board, game->gen->current_row_index, 2,
                   BOARD_VERTICAL_DIRECTION, 0);
-  set_cross_set_letter(get_cross_set_pointer(game->gen->board,
-                                             game->gen->current_row_index, 2,
-                                             BOARD_VERTICAL_DIRECTION, 0),
-                       ml);
+  uint64_t cross_set = 0;
+  set_cross_set_letter(&cross_set, ml);
+  set_cross_set(game->gen->board, game->gen->current_row_index, 2, cross_set,
+                BOARD_VERTICAL_DIRECTION, 0);
   execute_recursive_gen(game->gen, game->gen->current_anchor_col, player,
                         game->gen->current_anchor_col,
                         game->gen->current_anchor_col, 1);
   // it should generate HITHERMOST only
   assert(game->gen->move_list->count == 1);
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "5B HI(THERMOS)T 36"));
   reset_string(test_string);
@@ -188,7 +189,7 @@ void macondo_tests(SuperConfig *superconfig) {
   assert(game->gen->move_list->count == 1);
 
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "15C A(VENGED) 12"));
   reset_string(test_string);
@@ -207,7 +208,7 @@ void macondo_tests(SuperConfig *superconfig) {
   assert(game->gen->move_list->count == 1);
 
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "1L (F)A 5"));
   reset_string(test_string);
@@ -371,7 +372,7 @@ void macondo_tests(SuperConfig *superconfig) {
   generate_moves(game->gen, player, NULL, 0);
   assert(count_scoring_plays(game->gen->move_list) == 0);
   assert(count_nonscoring_plays(game->gen->move_list) == 1);
-  assert(game->gen->move_list->moves[0]->move_type == MOVE_TYPE_PASS);
+  assert(game->gen->move_list->moves[0].move_type == MOVE_TYPE_PASS);
 
   reset_game(game);
   reset_rack(player->rack);
@@ -505,7 +506,7 @@ void top_equity_play_recorder_test(SuperConfig *superconfig) {
   generate_moves(game->gen, player, NULL, 0);
 
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "14B hEaDW(OR)DS 106"));
   reset_string(test_string);
@@ -518,7 +519,7 @@ void top_equity_play_recorder_test(SuperConfig *superconfig) {
   generate_moves(game->gen, player, NULL, 0);
 
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "A1 OX(Y)P(HEN)B(UT)AZ(ON)E 1780"));
   reset_string(test_string);
@@ -549,12 +550,12 @@ void distinct_lexica_test(SuperConfig *superconfig) {
                      game->gen->letter_distribution);
   generate_moves_for_game(game);
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "8H SPORK 32"));
   reset_string(test_string);
 
-  play_move(game, game->gen->move_list->moves[0]);
+  play_move(game, &game->gen->move_list->moves[0]);
   reset_move_list(game->gen->move_list);
 
   // Play SCHIZIER, better than best CSW word of SCHERZI
@@ -563,12 +564,12 @@ void distinct_lexica_test(SuperConfig *superconfig) {
   generate_moves_for_game(game);
 
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "H8 (S)CHIZIER 146"));
   reset_string(test_string);
 
-  play_move(game, game->gen->move_list->moves[0]);
+  play_move(game, &game->gen->move_list->moves[0]);
   reset_move_list(game->gen->move_list);
 
   // Play WIGGLY, not GOLLYWOG because that's NWL only
@@ -577,12 +578,12 @@ void distinct_lexica_test(SuperConfig *superconfig) {
   generate_moves_for_game(game);
 
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "11G W(I)GGLY 28"));
   reset_string(test_string);
 
-  play_move(game, game->gen->move_list->moves[0]);
+  play_move(game, &game->gen->move_list->moves[0]);
   reset_move_list(game->gen->move_list);
 
   // Play 13C QUEAS(I)ER, not L3 SQUEA(K)ER(Y) because that's CSW only
@@ -591,12 +592,12 @@ void distinct_lexica_test(SuperConfig *superconfig) {
   generate_moves_for_game(game);
 
   write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
-                                           game->gen->move_list->moves[0],
+                                           &game->gen->move_list->moves[0],
                                            game->gen->letter_distribution);
   assert(!strcmp(test_string, "13C QUEAS(I)ER 88"));
   reset_string(test_string);
 
-  play_move(game, game->gen->move_list->moves[0]);
+  play_move(game, &game->gen->move_list->moves[0]);
   reset_move_list(game->gen->move_list);
 
   game->players[0]->strategy_params->play_recorder_type =
@@ -608,10 +609,761 @@ void distinct_lexica_test(SuperConfig *superconfig) {
   destroy_game(game);
 }
 
+// Changes how the game's moves are generated.
+typedef void (*GenerationSetup)(Game *game, void *setup_data);
+
+// Applies the setup, generates the moves and returns sorted copies
+// of them, leaving the move list empty.
+Move **generate_move_copies(Game *game, GenerationSetup setup,
+                            void *setup_data, int *number_of_moves) {
+  MoveList *move_list = game->gen->move_list;
+  setup(game, setup_data);
+  generate_moves_for_game(game);
+  sort_moves(move_list);
+  *number_of_moves = move_list->count;
+  Move **moves = malloc(sizeof(Move *) * *number_of_moves);
+  for (int i = 0; i < *number_of_moves; i++) {
+    moves[i] = create_move();
+    copy_move(&move_list->moves[i], moves[i]);
+  }
+  reset_move_list(move_list);
+  return moves;
+}
+
+void destroy_move_copies(Move **moves, int number_of_moves) {
+  for (int i = 0; i < number_of_moves; i++) {
+    destroy_move(moves[i]);
+  }
+  free(moves);
+}
+
+// Sorts the move list and asserts that it holds exactly the expected moves.
+void assert_moves_match(Move **expected_moves, int number_of_expected_moves,
+                        MoveList *move_list) {
+  sort_moves(move_list);
+  assert(move_list->count == number_of_expected_moves);
+  for (int i = 0; i < number_of_expected_moves; i++) {
+    assert(!compare_moves(expected_moves[i], &move_list->moves[i]));
+    assert(!compare_moves(&move_list->moves[i], expected_moves[i]));
+  }
+}
+
+// Asserts that the moves generated after each setup are the same and
+// returns how many there are. The recorder type of the player on turn
+// is restored afterward.
+int assert_generation_matches(Game *game, GenerationSetup setup_a,
+                              GenerationSetup setup_b, void *setup_data) {
+  Player *player = game->players[game->player_on_turn_index];
+  MoveList *move_list = game->gen->move_list;
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  int number_of_moves;
+  Move **expected_moves =
+      generate_move_copies(game, setup_a, setup_data, &number_of_moves);
+  setup_b(game, setup_data);
+  generate_moves_for_game(game);
+  assert_moves_match(expected_moves, number_of_moves, move_list);
+  reset_move_list(move_list);
+
+  destroy_move_copies(expected_moves, number_of_moves);
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+  return number_of_moves;
+}
+
+void setup_unchanged_generation(Game *game, void *setup_data) {
+  (void)game;
+  (void)setup_data;
+}
+
+void setup_all_recorder_generation(Game *game, void *setup_data) {
+  (void)setup_data;
+  game->players[game->player_on_turn_index]
+      ->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_ALL;
+}
+
+void setup_serial_generation(Game *game, void *setup_data) {
+  (void)setup_data;
+  set_movegen_threads(game->gen, 1);
+}
+
+void setup_parallel_generation(Game *game, void *setup_data) {
+  set_movegen_threads(game->gen, *(int *)setup_data);
+}
+
+void assert_moves_equal_for_thread_counts(Game *game, int number_of_threads) {
+  int number_of_moves =
+      assert_generation_matches(game, setup_serial_generation,
+                                setup_parallel_generation, &number_of_threads);
+  if (game->players[game->player_on_turn_index]
+          ->strategy_params->play_recorder_type == PLAY_RECORDER_TYPE_ALL) {
+    assert(number_of_moves > 1);
+  }
+  set_movegen_threads(game->gen, 1);
+}
+
+void parallel_movegen_test(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+
+  load_cgp(game, MANY_MOVES);
+  assert_moves_equal_for_thread_counts(game, 4);
+
+  reset_game(game);
+  load_cgp(game, VS_OXY);
+  assert_moves_equal_for_thread_counts(game, 3);
+
+  Player *player = game->players[game->player_on_turn_index];
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+  player->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_TOP_EQUITY;
+  assert_moves_equal_for_thread_counts(game, 3);
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+
+  destroy_game(game);
+
+  config = get_nwl_config(superconfig);
+  game = create_game(config);
+  player = game->players[0];
+  char test_string[100];
+  reset_string(test_string);
+
+  load_cgp(game, VS_JEREMY);
+  set_rack_to_string(player->rack, "DDESW??", game->gen->letter_distribution);
+  set_movegen_threads(game->gen, 4);
+  generate_moves(game->gen, player, NULL, 0);
+  assert(count_scoring_plays(game->gen->move_list) == 8285);
+  assert(count_nonscoring_plays(game->gen->move_list) == 1);
+
+  SortedMoveList *sorted_move_list =
+      create_sorted_move_list(game->gen->move_list);
+  write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
+                                           sorted_move_list->moves[0],
+                                           game->gen->letter_distribution);
+  assert(!strcmp(test_string, "14B hEaDW(OR)DS 106"));
+  reset_string(test_string);
+  destroy_sorted_move_list(sorted_move_list);
+
+  // Fewer threads reuse the workers that were already created.
+  struct MovegenWorker **workers = game->gen->workers;
+  set_movegen_threads(game->gen, 2);
+  assert(game->gen->workers == workers);
+  assert(game->gen->number_of_workers == 3);
+
+  // The workers read the board of the game, so they see
+  // the new position without being recreated.
+  reset_game(game);
+  reset_rack(player->rack);
+  load_cgp(game, VS_OXY);
+  set_rack_to_string(player->rack, "ABEOPXZ", game->gen->letter_distribution);
+  generate_moves(game->gen, player, NULL, 0);
+  assert(count_scoring_plays(game->gen->move_list) == 513);
+  assert(count_nonscoring_plays(game->gen->move_list) == 1);
+
+  sorted_move_list = create_sorted_move_list(game->gen->move_list);
+  write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
+                                           sorted_move_list->moves[0],
+                                           game->gen->letter_distribution);
+  assert(!strcmp(test_string, "A1 OX(Y)P(HEN)B(UT)AZ(ON)E 1780"));
+  reset_string(test_string);
+  destroy_sorted_move_list(sorted_move_list);
+  assert(game->gen->workers == workers);
+
+  destroy_game(game);
+}
+
+// Generates every play and checks that the limited play recorder
+// keeps exactly the best plays that satisfy its limit.
+void assert_limited_recorder_matches_all(Game *game, int play_recorder_type,
+                                         int max_recorded_moves,
+                                         double recorded_equity_window) {
+  Player *player = game->players[game->player_on_turn_index];
+  MoveList *move_list = game->gen->move_list;
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  int number_of_moves;
+  Move **all_moves = generate_move_copies(game, setup_all_recorder_generation,
+                                          NULL, &number_of_moves);
+  // The limited recorders are compared against the whole sorted list.
+  assert(number_of_moves > 1);
+  int number_of_expected_moves = 0;
+  double min_equity = all_moves[0]->equity - recorded_equity_window;
+  while (number_of_expected_moves < number_of_moves) {
+    Move *move = all_moves[number_of_expected_moves];
+    if (play_recorder_type == PLAY_RECORDER_TYPE_TOP_K
+            ? number_of_expected_moves == max_recorded_moves
+            : move->equity < min_equity) {
+      break;
+    }
+    number_of_expected_moves++;
+  }
+
+  player->strategy_params->play_recorder_type = play_recorder_type;
+  game->gen->max_recorded_moves = max_recorded_moves;
+  game->gen->recorded_equity_window = recorded_equity_window;
+  generate_moves_for_game(game);
+  assert_moves_match(all_moves, number_of_expected_moves, move_list);
+  reset_move_list(move_list);
+
+  destroy_move_copies(all_moves, number_of_moves);
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+}
+
+void assert_move_string(Game *game, Move *move, const char *expected_string) {
+  char test_string[100];
+  reset_string(test_string);
+  write_user_visible_move_to_end_of_buffer(test_string, game->gen->board, move,
+                                           game->gen->letter_distribution);
+  assert_strings_equal(test_string, (char *)expected_string);
+}
+
+void limited_play_recorder_test(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+
+  load_cgp(game, VS_ED);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_TOP_K, 1, 0);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_TOP_K, 15, 0);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_EQUITY_WINDOW,
+                                      0, 0);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_EQUITY_WINDOW,
+                                      0, 10);
+
+  reset_game(game);
+  load_cgp(game, MANY_MOVES);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_TOP_K, 100, 0);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_EQUITY_WINDOW,
+                                      0, 5);
+  set_movegen_threads(game->gen, 4);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_TOP_K, 100, 0);
+  assert_limited_recorder_matches_all(game, PLAY_RECORDER_TYPE_EQUITY_WINDOW,
+                                      0, 5);
+
+  destroy_game(game);
+
+  config = get_nwl_config(superconfig);
+  game = create_game(config);
+  Player *player = game->players[0];
+  MoveList *move_list = game->gen->move_list;
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  // Of the 8286 plays, only the two best are kept.
+  load_cgp(game, VS_JEREMY);
+  set_rack_to_string(player->rack, "DDESW??", game->gen->letter_distribution);
+  player->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_TOP_K;
+  game->gen->max_recorded_moves = 2;
+  generate_moves(game->gen, player, NULL, 0);
+  assert(move_list->count == 2);
+  sort_moves(move_list);
+  assert_move_string(game, &move_list->moves[0], "14B hEaDW(OR)DS 106");
+  assert_move_string(game, &move_list->moves[1], "14B hEaDW(OR)D 38");
+  reset_move_list(move_list);
+
+  // A window of 0 only keeps the best play.
+  player->strategy_params->play_recorder_type =
+      PLAY_RECORDER_TYPE_EQUITY_WINDOW;
+  game->gen->recorded_equity_window = 0;
+  generate_moves(game->gen, player, NULL, 0);
+  assert(move_list->count == 1);
+  assert_move_string(game, &move_list->moves[0], "14B hEaDW(OR)DS 106");
+  reset_move_list(move_list);
+
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+  destroy_game(game);
+}
+
+typedef struct VisitedPlayTotals {
+  int number_of_plays;
+  int number_of_exchanges;
+  int number_of_bingos;
+  int highest_score;
+  double highest_equity;
+} VisitedPlayTotals;
+
+void total_visited_play(const uint8_t *tiles, int number_of_tiles, int row,
+                        int col, int vertical, int tiles_played, int move_type,
+                        int score, double leave_value, void *visitor_data) {
+  assert(tiles);
+  assert(row >= 0 && row < BOARD_DIM && col >= 0 && col < BOARD_DIM);
+  assert(vertical == 0 || vertical == 1);
+  VisitedPlayTotals *totals = (VisitedPlayTotals *)visitor_data;
+  if (move_type == MOVE_TYPE_PLAY) {
+    int number_of_placed_tiles = 0;
+    for (int i = 0; i < number_of_tiles; i++) {
+      number_of_placed_tiles += tiles[i] != PLAYED_THROUGH_MARKER;
+    }
+    assert(number_of_placed_tiles == tiles_played);
+    totals->number_of_plays++;
+    if (tiles_played == RACK_SIZE) {
+      totals->number_of_bingos++;
+    }
+  } else {
+    assert(move_type == MOVE_TYPE_EXCHANGE);
+    assert(number_of_tiles == tiles_played);
+    totals->number_of_exchanges++;
+  }
+  if (score > totals->highest_score) {
+    totals->highest_score = score;
+  }
+  if (score + leave_value > totals->highest_equity) {
+    totals->highest_equity = score + leave_value;
+  }
+}
+
+void assert_visitor_matches_all(Game *game) {
+  Player *player = game->players[game->player_on_turn_index];
+  MoveList *move_list = game->gen->move_list;
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  int number_of_moves;
+  Move **all_moves = generate_move_copies(game, setup_all_recorder_generation,
+                                          NULL, &number_of_moves);
+  VisitedPlayTotals expected_totals = {0, 0, 0, 0, INITIAL_TOP_MOVE_EQUITY};
+  for (int i = 0; i < number_of_moves; i++) {
+    Move *move = all_moves[i];
+    if (move->move_type == MOVE_TYPE_PASS) {
+      continue;
+    }
+    if (move->move_type == MOVE_TYPE_PLAY) {
+      expected_totals.number_of_plays++;
+      if (move->tiles_played == RACK_SIZE) {
+        expected_totals.number_of_bingos++;
+      }
+    } else {
+      expected_totals.number_of_exchanges++;
+    }
+    if (move->score > expected_totals.highest_score) {
+      expected_totals.highest_score = move->score;
+    }
+    if (move->equity > expected_totals.highest_equity) {
+      expected_totals.highest_equity = move->equity;
+    }
+  }
+  destroy_move_copies(all_moves, number_of_moves);
+
+  VisitedPlayTotals totals = {0, 0, 0, 0, INITIAL_TOP_MOVE_EQUITY};
+  player->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_VISITOR;
+  set_move_visitor(game->gen, total_visited_play, &totals);
+  generate_moves_for_game(game);
+  assert(move_list->count == 0);
+  assert(totals.number_of_plays == expected_totals.number_of_plays);
+  assert(totals.number_of_exchanges == expected_totals.number_of_exchanges);
+  assert(totals.number_of_bingos == expected_totals.number_of_bingos);
+  assert(totals.highest_score == expected_totals.highest_score);
+  assert(within_epsilon(totals.highest_equity, expected_totals.highest_equity));
+
+  set_move_visitor(game->gen, NULL, NULL);
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+}
+
+void visitor_play_recorder_test(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+
+  load_cgp(game, VS_ED);
+  assert_visitor_matches_all(game);
+
+  reset_game(game);
+  load_cgp(game, MANY_MOVES);
+  assert_visitor_matches_all(game);
+  // The visitor is always called from the generating thread.
+  set_movegen_threads(game->gen, 4);
+  assert_visitor_matches_all(game);
+
+  destroy_game(game);
+
+  config = get_nwl_config(superconfig);
+  game = create_game(config);
+  Player *player = game->players[0];
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  // Every one of the 513 plays is visited and none is recorded.
+  load_cgp(game, VS_OXY);
+  set_rack_to_string(player->rack, "ABEOPXZ", game->gen->letter_distribution);
+  VisitedPlayTotals totals = {0, 0, 0, 0, INITIAL_TOP_MOVE_EQUITY};
+  player->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_VISITOR;
+  set_move_visitor(game->gen, total_visited_play, &totals);
+  generate_moves(game->gen, player, NULL, 0);
+  assert(game->gen->move_list->count == 0);
+  assert(totals.number_of_plays == 513);
+  assert(totals.number_of_exchanges == 0);
+  assert(totals.highest_score == 1780);
+
+  set_move_visitor(game->gen, NULL, NULL);
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+  destroy_game(game);
+}
+
+void setup_top_equity_recorder_generation(Game *game, void *setup_data) {
+  (void)setup_data;
+  game->players[game->player_on_turn_index]
+      ->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_TOP_EQUITY;
+}
+
+void assert_equity_threshold_matches_top_equity(Game *game,
+                                                double equity_offset) {
+  Player *player = game->players[game->player_on_turn_index];
+  MoveList *move_list = game->gen->move_list;
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  int number_of_moves;
+  Move **top_moves = generate_move_copies(
+      game, setup_top_equity_recorder_generation, NULL, &number_of_moves);
+  assert(number_of_moves == 1);
+
+  double equity_threshold = top_moves[0]->equity + equity_offset;
+  player->strategy_params->play_recorder_type =
+      PLAY_RECORDER_TYPE_EQUITY_THRESHOLD;
+  game->gen->equity_threshold = equity_threshold;
+  generate_moves_for_game(game);
+  // The first play over the threshold is the top play
+  // only when the threshold is just below it.
+  if (top_moves[0]->equity > equity_threshold) {
+    assert(move_list->count == 1);
+    assert(move_list->moves[0].equity > equity_threshold);
+  } else {
+    assert_moves_match(top_moves, 0, move_list);
+  }
+  reset_move_list(move_list);
+
+  destroy_move_copies(top_moves, number_of_moves);
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+}
+
+void equity_threshold_play_recorder_test(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+
+  load_cgp(game, VS_OXY);
+  set_rack_to_string(game->players[game->player_on_turn_index]->rack,
+                     "ABEOPXZ", game->gen->letter_distribution);
+  assert_equity_threshold_matches_top_equity(game, -20);
+  assert_equity_threshold_matches_top_equity(game, -0.5);
+  assert_equity_threshold_matches_top_equity(game, 0);
+
+  reset_game(game);
+  load_cgp(game, MANY_MOVES);
+  assert_equity_threshold_matches_top_equity(game, -5);
+  assert_equity_threshold_matches_top_equity(game, 0);
+  assert_equity_threshold_matches_top_equity(game, 1);
+
+  destroy_game(game);
+
+  config = get_nwl_config(superconfig);
+  game = create_game(config);
+  Player *player = game->players[0];
+  MoveList *move_list = game->gen->move_list;
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  // Only one play is worth more than 1700, so it is the one found.
+  load_cgp(game, VS_OXY);
+  set_rack_to_string(player->rack, "ABEOPXZ", game->gen->letter_distribution);
+  player->strategy_params->play_recorder_type =
+      PLAY_RECORDER_TYPE_EQUITY_THRESHOLD;
+  game->gen->equity_threshold = 1700;
+  generate_moves(game->gen, player, NULL, 0);
+  assert(game->gen->equity_threshold_exceeded);
+  assert(move_list->count == 1);
+  assert_move_string(game, &move_list->moves[0],
+                     "A1 OX(Y)P(HEN)B(UT)AZ(ON)E 1780");
+  reset_move_list(move_list);
+
+  // No play is worth more than 1800.
+  game->gen->equity_threshold = 1800;
+  generate_moves(game->gen, player, NULL, 0);
+  assert(!game->gen->equity_threshold_exceeded);
+  reset_move_list(move_list);
+
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+  destroy_game(game);
+}
+
+void sort_top_moves_test(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+  MoveList *move_list = game->gen->move_list;
+  int number_of_top_moves = 20;
+
+  load_cgp(game, MANY_MOVES);
+  generate_moves_for_game(game);
+  sort_moves(move_list);
+  int number_of_moves = move_list->count;
+  assert(number_of_moves > number_of_top_moves);
+  Move **sorted_moves = malloc(sizeof(Move *) * number_of_top_moves);
+  for (int i = 0; i < number_of_moves; i++) {
+    if (i > 0) {
+      assert(!compare_moves(&move_list->moves[i], &move_list->moves[i - 1]));
+    }
+    if (i < number_of_top_moves) {
+      sorted_moves[i] = create_move();
+      copy_move(&move_list->moves[i], sorted_moves[i]);
+    }
+  }
+  reset_move_list(move_list);
+
+  generate_moves_for_game(game);
+  sort_top_moves(move_list, number_of_top_moves);
+  assert(move_list->count == number_of_moves);
+  for (int i = 0; i < number_of_top_moves; i++) {
+    assert(!compare_moves(sorted_moves[i], &move_list->moves[i]));
+    assert(!compare_moves(&move_list->moves[i], sorted_moves[i]));
+    destroy_move(sorted_moves[i]);
+  }
+  for (int i = number_of_top_moves; i < number_of_moves; i++) {
+    assert(compare_moves(&move_list->moves[number_of_top_moves - 1],
+                         &move_list->moves[i]));
+  }
+  free(sorted_moves);
+  reset_move_list(move_list);
+
+  destroy_game(game);
+
+  config = get_nwl_config(superconfig);
+  game = create_game(config);
+  Player *player = game->players[0];
+  move_list = game->gen->move_list;
+
+  // Only the two best of the 8286 plays are ordered, and none is lost.
+  load_cgp(game, VS_JEREMY);
+  set_rack_to_string(player->rack, "DDESW??", game->gen->letter_distribution);
+  generate_moves(game->gen, player, NULL, 0);
+  sort_top_moves(move_list, 2);
+  assert(move_list->count == 8286);
+  assert_move_string(game, &move_list->moves[0], "14B hEaDW(OR)DS 106");
+  assert_move_string(game, &move_list->moves[1], "14B hEaDW(OR)D 38");
+  reset_move_list(move_list);
+
+  destroy_game(game);
+}
+
+void setup_uncached_generation(Game *game, void *setup_data) {
+  (void)setup_data;
+  set_leave_cache_capacity(game->gen, 0);
+}
+
+void setup_cached_generation(Game *game, void *setup_data) {
+  (void)setup_data;
+  set_leave_cache_capacity(game->gen, LEAVE_CACHE_SIZE);
+}
+
+void assert_leave_cache_matches_uncached(Game *game) {
+  // The first cached generation misses and the second one hits.
+  assert_generation_matches(game, setup_uncached_generation,
+                            setup_cached_generation, NULL);
+  assert_generation_matches(game, setup_unchanged_generation,
+                            setup_unchanged_generation, NULL);
+  assert(game->gen->leave_cache->misses == 1);
+  assert(game->gen->leave_cache->hits == 2);
+}
+
+void leave_cache_test(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+
+  load_cgp(game, VS_ED);
+  assert_leave_cache_matches_uncached(game);
+
+  reset_game(game);
+  load_cgp(game, MANY_MOVES);
+  assert_leave_cache_matches_uncached(game);
+
+  destroy_game(game);
+
+  // The cached leaves give the same plays as the macondo tests.
+  config = get_nwl_config(superconfig);
+  game = create_game(config);
+  Player *player = game->players[0];
+  set_leave_cache_capacity(game->gen, LEAVE_CACHE_SIZE);
+
+  load_cgp(game, VS_ED);
+  set_rack_to_string(player->rack, "AFGIIIS", game->gen->letter_distribution);
+  for (int i = 0; i < 2; i++) {
+    generate_moves(game->gen, player, NULL, 1);
+    assert(count_scoring_plays(game->gen->move_list) == 219);
+    assert(count_nonscoring_plays(game->gen->move_list) == 64);
+    reset_move_list(game->gen->move_list);
+  }
+  assert(game->gen->leave_cache->misses == 1);
+  assert(game->gen->leave_cache->hits == 1);
+
+  destroy_game(game);
+}
+
+void setup_undeferred_generation(Game *game, void *setup_data) {
+  game->gen->defer_blank_designations = 0;
+  game->players[game->player_on_turn_index]
+      ->strategy_params->play_recorder_type = *(int *)setup_data;
+}
+
+void setup_deferred_generation(Game *game, void *setup_data) {
+  game->gen->defer_blank_designations = 1;
+  game->players[game->player_on_turn_index]
+      ->strategy_params->play_recorder_type = *(int *)setup_data;
+}
+
+void assert_deferred_visits_match_undeferred(Game *game) {
+  Player *player = game->players[game->player_on_turn_index];
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+  player->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_VISITOR;
+
+  VisitedPlayTotals totals[2];
+  for (int i = 0; i < 2; i++) {
+    VisitedPlayTotals initial_totals = {0, 0, 0, 0, INITIAL_TOP_MOVE_EQUITY};
+    totals[i] = initial_totals;
+    game->gen->defer_blank_designations = i;
+    set_move_visitor(game->gen, total_visited_play, &totals[i]);
+    generate_moves_for_game(game);
+    assert(game->gen->move_list->count == 0);
+  }
+  assert(totals[0].number_of_plays > 0);
+  assert(totals[0].number_of_plays == totals[1].number_of_plays);
+  assert(totals[0].number_of_exchanges == totals[1].number_of_exchanges);
+  assert(totals[0].number_of_bingos == totals[1].number_of_bingos);
+  assert(totals[0].highest_score == totals[1].highest_score);
+  assert(within_epsilon(totals[0].highest_equity, totals[1].highest_equity));
+
+  set_move_visitor(game->gen, NULL, NULL);
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+}
+
+// The equity threshold recorder keeps the first play found over the
+// threshold, which depends on the search order, so only whether
+// a play is found is compared.
+void assert_deferred_threshold_matches_undeferred(Game *game,
+                                                  double equity_offset) {
+  Player *player = game->players[game->player_on_turn_index];
+  MoveList *move_list = game->gen->move_list;
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+
+  int number_of_moves;
+  Move **top_moves = generate_move_copies(
+      game, setup_top_equity_recorder_generation, NULL, &number_of_moves);
+  double equity_threshold = top_moves[0]->equity + equity_offset;
+  destroy_move_copies(top_moves, number_of_moves);
+
+  player->strategy_params->play_recorder_type =
+      PLAY_RECORDER_TYPE_EQUITY_THRESHOLD;
+  game->gen->equity_threshold = equity_threshold;
+  int counts[2];
+  for (int i = 0; i < 2; i++) {
+    game->gen->defer_blank_designations = i;
+    generate_moves_for_game(game);
+    counts[i] = move_list->count;
+    if (counts[i] > 0) {
+      assert(move_list->moves[0].equity > equity_threshold);
+    }
+    reset_move_list(move_list);
+  }
+  assert(counts[0] == (equity_offset < 0));
+  assert(counts[0] == counts[1]);
+
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+}
+
+void assert_deferred_blanks_match_undeferred(Game *game) {
+  int play_recorder_type = PLAY_RECORDER_TYPE_ALL;
+  assert_generation_matches(game, setup_undeferred_generation,
+                            setup_deferred_generation, &play_recorder_type);
+  // Designations that cannot beat the best play are not recorded.
+  play_recorder_type = PLAY_RECORDER_TYPE_TOP_EQUITY;
+  assert_generation_matches(game, setup_undeferred_generation,
+                            setup_deferred_generation, &play_recorder_type);
+  play_recorder_type = PLAY_RECORDER_TYPE_TOP_K;
+  game->gen->max_recorded_moves = 10;
+  assert_generation_matches(game, setup_undeferred_generation,
+                            setup_deferred_generation, &play_recorder_type);
+  assert_deferred_visits_match_undeferred(game);
+  assert_deferred_threshold_matches_undeferred(game, -5);
+  assert_deferred_threshold_matches_undeferred(game, 0);
+  game->gen->defer_blank_designations = 0;
+}
+
+void assert_deferred_blanks_match_undeferred_for_rack(Game *game,
+                                                      const char *cgp,
+                                                      const char *rack) {
+  reset_game(game);
+  load_cgp(game, cgp);
+  set_rack_to_string(game->players[game->player_on_turn_index]->rack, rack,
+                     game->gen->letter_distribution);
+  assert_deferred_blanks_match_undeferred(game);
+}
+
+void blank_designation_deferral_test(SuperConfig *superconfig) {
+  Config *config = get_csw_config(superconfig);
+  Game *game = create_game(config);
+
+  load_cgp(game, MANY_MOVES);
+  assert_deferred_blanks_match_undeferred(game);
+
+  assert_deferred_blanks_match_undeferred_for_rack(game, VS_MATT, "DEIR?T?");
+  assert_deferred_blanks_match_undeferred_for_rack(game, VS_ED, "??");
+  assert_deferred_blanks_match_undeferred_for_rack(game, VS_JEREMY,
+                                                   "DDESW??");
+  assert_deferred_blanks_match_undeferred_for_rack(game, OPENING_CGP,
+                                                   "DEGORV?");
+
+  destroy_game(game);
+
+  // Deferring finds the same plays as the macondo tests.
+  config = get_nwl_config(superconfig);
+  game = create_game(config);
+  Player *player = game->players[0];
+  game->gen->defer_blank_designations = 1;
+  char test_string[100];
+  reset_string(test_string);
+
+  load_cgp(game, VS_ED);
+  set_rack_to_string(player->rack, "??", game->gen->letter_distribution);
+  generate_moves(game->gen, player, NULL, 1);
+  assert(count_scoring_plays(game->gen->move_list) == 1961);
+  assert(count_nonscoring_plays(game->gen->move_list) == 3);
+
+  reset_game(game);
+  reset_rack(player->rack);
+
+  load_cgp(game, VS_JEREMY);
+  set_rack_to_string(player->rack, "DDESW??", game->gen->letter_distribution);
+  generate_moves(game->gen, player, NULL, 0);
+  assert(count_scoring_plays(game->gen->move_list) == 8285);
+  assert(count_nonscoring_plays(game->gen->move_list) == 1);
+  SortedMoveList *sorted_move_list =
+      create_sorted_move_list(game->gen->move_list);
+  write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
+                                           sorted_move_list->moves[0],
+                                           game->gen->letter_distribution);
+  assert(!strcmp(test_string, "14B hEaDW(OR)DS 106"));
+  reset_string(test_string);
+  destroy_sorted_move_list(sorted_move_list);
+
+  // The top equity recorder designates the blanks of the best play.
+  int saved_recorder_type = player->strategy_params->play_recorder_type;
+  player->strategy_params->play_recorder_type = PLAY_RECORDER_TYPE_TOP_EQUITY;
+  reset_move_list(game->gen->move_list);
+  generate_moves(game->gen, player, NULL, 0);
+  assert_move_string(game, &game->gen->move_list->moves[0],
+                     "14B hEaDW(OR)DS 106");
+  player->strategy_params->play_recorder_type = saved_recorder_type;
+
+  reset_game(game);
+  reset_rack(player->rack);
+
+  set_rack_to_string(player->rack, "DEGORV?", game->gen->letter_distribution);
+  generate_moves(game->gen, player, NULL, 1);
+  assert(count_scoring_plays(game->gen->move_list) == 3307);
+  assert(count_nonscoring_plays(game->gen->move_list) == 128);
+
+  destroy_game(game);
+}
+
 void test_movegen(SuperConfig *superconfig) {
   macondo_tests(superconfig);
   exchange_tests(superconfig);
   equity_test(superconfig);
   top_equity_play_recorder_test(superconfig);
   distinct_lexica_test(superconfig);
+  parallel_movegen_test(superconfig);
+  limited_play_recorder_test(superconfig);
+  visitor_play_recorder_test(superconfig);
+  equity_threshold_play_recorder_test(superconfig);
+  sort_top_moves_test(superconfig);
+  leave_cache_test(superconfig);
+  blank_designation_deferral_test(superconfig);
 }
\ No newline at end of file
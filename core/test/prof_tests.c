@@ -1,16 +1,28 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "autoplay_test.h"
 #include "prof_tests.h"
 #include "test_constants.h"
 #include "test_util.h"
 
 #include "../src/config.h"
+#include "../src/constants.h"
 #include "../src/game.h"
+#include "../src/kwg.h"
 #include "../src/movegen.h"
 
+#define KWG_LAYOUT_BENCHMARK_ITERATIONS 20
+
 void many_moves(Config *config) {
   Game *game = create_game(config);
   load_cgp(game, MANY_MOVES);
@@ -22,7 +34,92 @@ void many_moves(Config *config) {
   destroy_game(game);
 }
 
+// Returns a file descriptor counting the last level cache misses of
+// this thread, or -1 if hardware counters are not available.
+int open_cache_miss_counter() {
+#if defined(__linux__)
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+  return -1;
+#endif
+}
+
+void start_cache_miss_counter(int fd) {
+#if defined(__linux__)
+  if (fd >= 0) {
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#else
+  (void)fd;
+#endif
+}
+
+long long stop_cache_miss_counter(int fd) {
+  long long count = -1;
+#if defined(__linux__)
+  if (fd >= 0) {
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+      count = -1;
+    }
+  }
+#else
+  (void)fd;
+#endif
+  return count;
+}
+
+void many_moves_with_kwg_layout(Config *config, int load_mode,
+                                const char *layout_name) {
+  KWG *kwg = create_kwg_with_load_mode(
+      config->player_1_strategy_params->kwg_filename, load_mode);
+  if (config->use_kwg_index) {
+    build_kwg_index(kwg);
+  }
+  Game *game = create_game(config);
+  game->players[0]->strategy_params->kwg = kwg;
+  game->players[1]->strategy_params->kwg = kwg;
+  load_cgp(game, MANY_MOVES);
+
+  int cache_miss_fd = open_cache_miss_counter();
+  start_cache_miss_counter(cache_miss_fd);
+  clock_t begin = clock();
+  for (int i = 0; i < KWG_LAYOUT_BENCHMARK_ITERATIONS; i++) {
+    reset_move_list(game->gen->move_list);
+    generate_moves_for_game(game);
+  }
+  clock_t end = clock();
+  long long cache_misses = stop_cache_miss_counter(cache_miss_fd);
+  if (cache_miss_fd >= 0) {
+    close(cache_miss_fd);
+  }
+
+  printf("%s layout: %d moves, %0.6f seconds per generation", layout_name,
+         game->gen->move_list->count,
+         (double)(end - begin) / CLOCKS_PER_SEC /
+             KWG_LAYOUT_BENCHMARK_ITERATIONS);
+  if (cache_misses >= 0) {
+    printf(", %lld cache misses per generation",
+           cache_misses / KWG_LAYOUT_BENCHMARK_ITERATIONS);
+  } else {
+    printf(", cache miss counter unavailable");
+  }
+  printf("\n");
+  destroy_game(game);
+  destroy_kwg(kwg);
+}
+
 void prof_tests(Config *config) {
-  printf("unimplemented: %p\n", config);
-  abort();
-}
\ No newline at end of file
+  many_moves_with_kwg_layout(config, KWG_LOAD_MODE_COPY, "file");
+  many_moves_with_kwg_layout(config, KWG_LOAD_MODE_RELAYOUT,
+                             "breadth first");
+}
@@ -115,4 +115,75 @@ void test_rack_main(SuperConfig *superconfig) {
   destroy_rack(expected_rack);
 }
 
-void test_rack(SuperConfig *superconfig) { test_rack_main(superconfig); }
+uint64_t pack_rack_letters(Rack *rack) {
+  uint64_t signature = 0;
+  for (int i = 0; i < rack->array_size; i++) {
+    for (int j = 0; j < rack->array[i]; j++) {
+      signature = (signature << 8) | (uint64_t)(i + 1);
+    }
+  }
+  return signature;
+}
+
+void test_rack_signature(SuperConfig *superconfig) {
+  Config *config = get_nwl_config(superconfig);
+  LetterDistribution *letter_distribution = config->letter_distribution;
+  Rack *rack = create_rack(letter_distribution->size);
+  Rack *other_rack = create_rack(letter_distribution->size);
+
+  set_rack_to_string(rack, "ZEBRA?E", letter_distribution);
+  set_rack_to_string(other_rack, "?ABEERZ", letter_distribution);
+  assert(get_rack_signature(rack) == pack_rack_letters(rack));
+  assert(get_rack_signature(rack) == get_rack_signature(other_rack));
+  assert(rack->hash == other_rack->hash);
+
+  // Taking from the middle and the ends keeps the letters sorted.
+  const char *taken = "E?ZEB";
+  for (int i = 0; taken[i]; i++) {
+    char letter[2] = {taken[i], '\0'};
+    take_letter_from_rack(
+        rack, human_readable_letter_to_machine_letter(letter_distribution,
+                                                      letter));
+    assert(get_rack_signature(rack) == pack_rack_letters(rack));
+  }
+
+  // The signature is rebuilt when a large rack shrinks to fit.
+  set_rack_to_string(rack, "AEEIIOUUY", letter_distribution);
+  take_letter_from_rack(rack, human_readable_letter_to_machine_letter(
+                                  letter_distribution, "U"));
+  assert(get_rack_signature(rack) == pack_rack_letters(rack));
+  add_letter_to_rack(rack, BLANK_MACHINE_LETTER);
+  take_letter_from_rack(rack, human_readable_letter_to_machine_letter(
+                                  letter_distribution, "Y"));
+  assert(get_rack_signature(rack) == pack_rack_letters(rack));
+
+  // Taking a letter the rack lacks leaves the signature right once the
+  // letter is returned.
+  set_rack_to_string(rack, "ABE", letter_distribution);
+  uint8_t missing_letter =
+      human_readable_letter_to_machine_letter(letter_distribution, "Z");
+  take_letter_from_rack(rack, missing_letter);
+  take_letter_from_rack(rack, missing_letter);
+  add_letter_to_rack(rack, BLANK_MACHINE_LETTER);
+  take_letter_from_rack(rack, human_readable_letter_to_machine_letter(
+                                  letter_distribution, "B"));
+  add_letter_to_rack(rack, missing_letter);
+  add_letter_to_rack(rack, missing_letter);
+  assert(get_rack_signature(rack) == pack_rack_letters(rack));
+  set_rack_to_string(other_rack, "?AE", letter_distribution);
+  assert(get_rack_signature(rack) == get_rack_signature(other_rack));
+  assert(rack->hash == other_rack->hash);
+
+  // Racks are copied whole.
+  copy_rack_into(other_rack, rack);
+  assert(equal_rack(rack, other_rack));
+  assert(get_rack_signature(other_rack) == get_rack_signature(rack));
+
+  destroy_rack(rack);
+  destroy_rack(other_rack);
+}
+
+void test_rack(SuperConfig *superconfig) {
+  test_rack_main(superconfig);
+  test_rack_signature(superconfig);
+}
@@ -553,7 +553,7 @@ void test_shadow_top_move(SuperConfig *superconfig) {
 
   // Top play should be L1 Q(I)
   load_and_generate(game, player, UEY_CGP, "ACEQOOV", 1);
-  assert(within_epsilon(game->gen->move_list->moves[0]->score, 21));
+  assert(within_epsilon(game->gen->move_list->moves[0].score, 21));
 
   player->strategy_params->move_sorting = original_move_sorting;
   player->strategy_params->play_recorder_type = original_recorder_type;
@@ -4,11 +4,15 @@
 #include <time.h>
 #include <unistd.h> // for sleep
 
+#include "../src/gameplay.h"
 #include "../src/move.h"
+#include "../src/rollout_cache.h"
 #include "../src/sim.h"
 #include "../src/winpct.h"
 
+#include "move_print.h"
 #include "superconfig.h"
+#include "test_constants.h"
 #include "test_util.h"
 
 void print_sim_stats(Simmer *simmer, Game *game) {
@@ -64,6 +68,22 @@ void test_sim_single_iteration(SuperConfig *superconfig,
   destroy_simmer(simmer);
 }
 
+void test_sim_restores_movegen_threads(SuperConfig *superconfig,
+                                       ThreadControl *thread_control) {
+  Config *config = get_nwl_config(superconfig);
+  Game *game = create_game(config);
+  draw_rack_to_string(game->gen->bag, game->players[0]->rack, "AEIQRST",
+                      game->gen->letter_distribution);
+  Simmer *simmer = create_simmer(config);
+  int movegen_threads = game->gen->number_of_threads;
+  simulate(thread_control, simmer, game, NULL, 2, movegen_threads + 1, 15, 1,
+           SIM_STOPPING_CONDITION_NONE, 1);
+  assert(game->gen->number_of_threads == movegen_threads);
+
+  destroy_game(game);
+  destroy_simmer(simmer);
+}
+
 void test_more_iterations(SuperConfig *superconfig,
                           ThreadControl *thread_control) {
   Config *config = get_nwl_config(superconfig);
@@ -211,12 +231,66 @@ void test_play_similarity(SuperConfig *superconfig,
   destroy_simmer(simmer);
 }
 
+void test_rollout_cache(SuperConfig *superconfig,
+                        ThreadControl *thread_control) {
+  Config *config = superconfig->nwl_config;
+  Game *game = create_game(config);
+  // With the bag empty, the opponent keeps the same rack, so every
+  // iteration rolls out the same positions.
+  load_cgp(game,
+           "7N6M/5ZOON4AA/7B5UN/2S4L3LADY/2T4E2QI1I1/2A2PORN3NOR/"
+           "2BICE2AA1DA1E/6GUVS1OP1F/8ET1LA1U/5J3R1E1UT/4VOTE1I1R1NE/"
+           "5G1MICKIES1/6FE1T1THEW/6OR3E1XI/6OY6G ADEHIL?/DIRSW? 300/310 0 "
+           "lex NWL20;");
+  assert(game->gen->bag->last_tile_index == -1);
+  Simmer *simmer = create_simmer(config);
+  simulate(thread_control, simmer, game, NULL, 2, 1, 10, 100,
+           SIM_STOPPING_CONDITION_NONE, 0);
+  assert(thread_control->halt_status == HALT_STATUS_MAX_ITERATIONS);
+  int lookups = atomic_load(&simmer->rollout_cache_lookups);
+  int hits = atomic_load(&simmer->rollout_cache_hits);
+  assert(lookups > 0);
+  assert(hits >= lookups * 9 / 10);
+  // Rollouts that miss generate moves, which looks up the leave cache.
+  assert(atomic_load(&simmer->leave_cache_lookups) > 0);
+  assert(unhalt(thread_control));
+
+  // A cached top move is found by its key and returned as it was stored.
+  RolloutCache *rollout_cache = create_rollout_cache(ROLLOUT_CACHE_SIZE);
+  reset_game(game);
+  load_cgp(game, VS_OXY);
+  set_rack_to_string(game->players[game->player_on_turn_index]->rack,
+                     "ABEOPXZ", game->gen->letter_distribution);
+  uint64_t position_key = board_hash(game->gen->board);
+  int found;
+  RolloutCacheEntry *entry =
+      lookup_rollout_cache(rollout_cache, position_key, &found);
+  assert(!found);
+  set_rollout_cache_entry(entry, position_key, get_top_equity_move(game));
+  entry = lookup_rollout_cache(rollout_cache, position_key, &found);
+  assert(found);
+  assert(rollout_cache->hits == 1);
+  assert(rollout_cache->misses == 1);
+  char test_string[100];
+  reset_string(test_string);
+  write_user_visible_move_to_end_of_buffer(test_string, game->gen->board,
+                                           &entry->top_move,
+                                           game->gen->letter_distribution);
+  assert_strings_equal(test_string, "A1 OX(Y)P(HEN)B(UT)AZ(ON)E 1780");
+  destroy_rollout_cache(rollout_cache);
+
+  destroy_game(game);
+  destroy_simmer(simmer);
+}
+
 void test_sim(SuperConfig *superconfig) {
   ThreadControl *thread_control = create_thread_control(NULL);
   test_win_pct(superconfig);
   test_sim_single_iteration(superconfig, thread_control);
+  test_sim_restores_movegen_threads(superconfig, thread_control);
   test_more_iterations(superconfig, thread_control);
   test_play_similarity(superconfig, thread_control);
+  test_rollout_cache(superconfig, thread_control);
   // And run a perf test.
   int threads = superconfig->nwl_config->number_of_threads;
   char *backup_cgp = superconfig->nwl_config->cgp;
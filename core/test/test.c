@@ -11,6 +11,7 @@
 #include "alphabet_test.h"
 #include "autoplay_test.h"
 #include "bag_test.h"
+#include "board_dim_test.h"
 #include "board_test.h"
 #include "config_test.h"
 #include "cross_set_test.h"
@@ -20,9 +21,11 @@
 #include "gcg_test.h"
 #include "gen_all_test.h"
 #include "infer_test.h"
+#include "kwg_test.h"
 #include "leave_map_test.h"
 #include "leaves_test.h"
 #include "letter_distribution_test.h"
+#include "move_count.h"
 #include "movegen_test.h"
 #include "play_recorder_test.h"
 #include "prof_tests.h"
@@ -42,6 +45,7 @@ void unit_tests(SuperConfig *superconfig) {
 
   // Test the readonly data first
   test_alphabet(superconfig);
+  test_kwg(superconfig);
   test_letter_distribution(superconfig);
   test_str_to_machine_letters(superconfig);
   test_leaves(superconfig, "./data/lexica/CSW21.csv");
@@ -61,6 +65,7 @@ void unit_tests(SuperConfig *superconfig) {
   test_infer(superconfig);
   test_sim(superconfig);
   test_ucgi_command();
+  test_board_dim();
   test_gcg();
   test_autoplay(superconfig);
   test_wasm_api();
@@ -111,37 +116,45 @@ int main(int argc, char *argv[]) {
     perf_test_multithread_blocking_sim(config, thread_control);
     destroy_thread_control(thread_control);
     destroy_config(config);
+  } else if (!strcmp(argv[1], CMD_COUNT)) {
+    Config *config = create_config_from_args(argc, argv);
+    count_moves(config);
+    destroy_config(config);
   } else if (!strcmp(argv[1], CMD_UNIT_TESTS)) {
     Config *csw_config = create_config(
         "./data/letterdistributions/english.csv", "", "./data/lexica/CSW21.kwg",
         "./data/lexica/CSW21.klv2", SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL, "",
         "", -1, -1, 0, 10000, 0, 0, NULL, 0, 0, 0, 0, 1,
-        "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY);
+        "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY,
+        KWG_LOAD_MODE_MMAP, 1, LEAVE_CACHE_SIZE, 0);
 
     Config *nwl_config = create_config(
         "./data/letterdistributions/english.csv", "", "./data/lexica/NWL20.kwg",
         "./data/lexica/CSW21.klv2", SORT_BY_SCORE, PLAY_RECORDER_TYPE_ALL, "",
         "", -1, -1, 0, 10000, 0, 0, NULL, 0, 0, 0, 0, 1,
-        "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY);
+        "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY,
+        KWG_LOAD_MODE_RELAYOUT, 1, LEAVE_CACHE_SIZE, 0);
 
     Config *osps_config = create_config(
         // no OSPS kwg yet, use later when we have tests.
         "./data/letterdistributions/polish.csv", "", "./data/lexica/OSPS44.kwg",
         "", SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL, "", "", -1, -1, 0, 10000, 0,
         0, NULL, 0, 0, 0, 0, 1, "./data/strategy/default_english/winpct.csv",
-        MOVE_LIST_CAPACITY);
+        MOVE_LIST_CAPACITY, KWG_LOAD_MODE_MMAP, 0, LEAVE_CACHE_SIZE, 0);
 
     Config *disc_config = create_config(
         "./data/letterdistributions/catalan.csv", "", "./data/lexica/DISC2.kwg",
         "./data/lexica/catalan.klv2", SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL,
         "", "", -1, -1, 0, 10000, 0, 0, NULL, 0, 0, 0, 0, 1,
-        "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY);
+        "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY,
+        KWG_LOAD_MODE_MMAP, 0, LEAVE_CACHE_SIZE, 0);
 
     Config *distinct_lexica_config = create_config(
         "./data/letterdistributions/english.csv", "", "./data/lexica/CSW21.kwg",
         "./data/lexica/CSW21.klv2", SORT_BY_EQUITY, PLAY_RECORDER_TYPE_ALL,
         "./data/lexica/NWL20.kwg", "", -1, -1, 0, 10000, 0, 0, NULL, 0, 0, 0, 0,
-        1, "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY);
+        1, "./data/strategy/default_english/winpct.csv", MOVE_LIST_CAPACITY,
+        KWG_LOAD_MODE_MMAP, 0, LEAVE_CACHE_SIZE, 0);
 
     SuperConfig *superconfig =
         create_superconfig(csw_config, nwl_config, osps_config, disc_config,
@@ -9,6 +9,7 @@
 #define CMD_TOPVALL "topvall"
 #define CMD_SIM "sim"
 #define CMD_SIM_STOPPING "simstopping"
+#define CMD_COUNT "count"
 
 #define EMPTY_CGP                                                              \
   "15/15/15/15/15/15/15/15/15/15/15/15/15/15/15 / 0/0 0 lex CSW21;"